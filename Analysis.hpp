@@ -0,0 +1,156 @@
+// Analysis.hpp
+#pragma once
+#include "Board.hpp"
+#include "MinimaxAI.hpp"
+#include "Notation.hpp"
+#include <chrono>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Потоковый разбор позиций: строка входа — позиция в нотации
+// Notation.hpp, строка выхода — её оценка. Вход не читается целиком:
+// в памяти только текущая строка и движки (по одному на поле
+// и сторону) с ограниченной транспозиционной таблицей, так что память
+// не зависит от размера файла. Результат каждой позиции уходит
+// в выход сразу, пачками по flushEvery строк.
+//
+// Пустые строки и строки с '#' пропускаются. Выход — CSV:
+//   Line,Position,Status,Move,Score,Depth,Nodes,TimeMs
+// Status: ok, X / O / draw (позиция уже кончилась) или error: причина.
+class StreamAnalyzer {
+public:
+    struct Options {
+        int depth;
+        long long timeMs;       // > 0 — итеративное углубление с лимитом
+        size_t cacheLimit;      // потолок таблицы каждого движка
+        size_t flushEvery;
+
+        Options() : depth(9), timeMs(0), cacheLimit(1 << 18), flushEvery(64) {}
+    };
+
+    struct Summary {
+        size_t positions;
+        size_t errors;
+        size_t terminal;
+        size_t nodes;
+
+        Summary() : positions(0), errors(0), terminal(0), nodes(0) {}
+    };
+
+private:
+    struct Engine {
+        int size;
+        int winLength;
+        CellState side;
+        std::unique_ptr<MinimaxAI> ai;
+    };
+
+    Options options_;
+    std::vector<Engine> engines_;
+
+    MinimaxAI& engineFor(const Board& board, CellState side) {
+        for (Engine& engine : engines_) {
+            if (engine.size == board.getSize() && engine.winLength == board.getWinLength()
+                && engine.side == side) {
+                return *engine.ai;
+            }
+        }
+        Engine engine;
+        engine.size = board.getSize();
+        engine.winLength = board.getWinLength();
+        engine.side = side;
+        engine.ai.reset(new MinimaxAI(side == CellState::X ? Player::X : Player::O,
+                                      options_.depth, true));
+        engine.ai->setCacheLimit(options_.cacheLimit);
+        if (engine.size >= LARGE_BOARD_MIN_SIZE) {
+            engine.ai->setLargeBoardMode();
+        }
+        engines_.push_back(std::move(engine));
+        return *engines_.back().ai;
+    }
+
+    static std::string trim(const std::string& line) {
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return std::string();
+        }
+        size_t end = line.find_last_not_of(" \t\r");
+        return line.substr(begin, end - begin + 1);
+    }
+
+    // Запятые во входе (битая строка) не должны ломать столбцы CSV
+    static std::string csvSafe(std::string text) {
+        for (char& c : text) {
+            if (c == ',') {
+                c = ';';
+            }
+        }
+        return text;
+    }
+
+public:
+    explicit StreamAnalyzer(const Options& options = Options()) : options_(options) {}
+
+    static const char* header() {
+        return "Line,Position,Status,Move,Score,Depth,Nodes,TimeMs";
+    }
+
+    Summary run(std::istream& in, std::ostream& out) {
+        Summary summary;
+        std::string line;
+        std::string buffer;
+        size_t lineNumber = 0;
+        size_t pending = 0;
+
+        out << header() << '\n';
+        while (std::getline(in, line)) {
+            ++lineNumber;
+            std::string text = trim(line);
+            if (text.empty() || text[0] == '#') {
+                continue;
+            }
+            ++summary.positions;
+            buffer += std::to_string(lineNumber) + "," + csvSafe(text) + ",";
+
+            Board board;
+            CellState side;
+            std::string error;
+            if (!notation::parse(text, board, side, &error)) {
+                ++summary.errors;
+                buffer += "error: " + csvSafe(error) + ",,,,,\n";
+            } else if (board.checkWin(CellState::X) || board.checkWin(CellState::O)
+                       || board.isFull()) {
+                ++summary.terminal;
+                buffer += board.checkWin(CellState::X) ? "X"
+                        : board.checkWin(CellState::O) ? "O" : "draw";
+                buffer += ",,,,,\n";
+            } else {
+                MinimaxAI& ai = engineFor(board, side);
+                MoveEvaluation eval = options_.timeMs > 0
+                    ? ai.findBestMoveTimed(board, std::chrono::milliseconds(options_.timeMs))
+                    : ai.findBestMove(board);
+                const AIStatistics& stats = ai.getStatistics();
+                summary.nodes += stats.nodesVisited;
+                buffer += "ok," + std::to_string(eval.move.row) + " "
+                        + std::to_string(eval.move.col) + ","
+                        + std::to_string(eval.score) + ","
+                        + std::to_string(stats.depthReached) + ","
+                        + std::to_string(stats.nodesVisited) + ","
+                        + std::to_string(stats.timeMs) + "\n";
+            }
+
+            if (++pending >= options_.flushEvery) {
+                out << buffer;
+                out.flush();
+                buffer.clear();
+                pending = 0;
+            }
+        }
+        out << buffer;
+        out.flush();
+        return summary;
+    }
+};
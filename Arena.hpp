@@ -0,0 +1,127 @@
+// Arena.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+// Монотонная арена: память выдаётся сдвигом указателя внутри блоков,
+// освобождение отдельных кусков ничего не делает. Вся память
+// возвращается разом через reset() за O(1) — блоки остаются в цепочке
+// и переиспользуются следующим поиском, так что после прогрева арена
+// не обращается к общей куче вовсе.
+//
+// Арена не потокобезопасна: одна арена — один поиск в одном потоке.
+class MonotonicArena : public std::pmr::memory_resource {
+private:
+    struct Block {
+        Block* next;
+        size_t capacity; // полезный размер без заголовка
+    };
+
+    Block* head_;     // первый блок цепочки
+    Block* current_;  // блок, из которого сейчас выдаётся память
+    size_t offset_;   // занято байт в current_
+    size_t usedBefore_; // занято в блоках до current_
+    size_t reserved_;
+    size_t initialBlockSize_;
+
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+    static constexpr size_t HEADER_SIZE =
+        (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+    static unsigned char* blockData(Block* block) {
+        return reinterpret_cast<unsigned char*>(block) + HEADER_SIZE;
+    }
+
+    // Отступ до ближайшего адреса, кратного alignment (степень двойки)
+    size_t paddingFor(size_t offset, size_t alignment) const {
+        uintptr_t address = reinterpret_cast<uintptr_t>(blockData(current_) + offset);
+        return static_cast<size_t>((alignment - (address & (alignment - 1))) & (alignment - 1));
+    }
+
+    Block* newBlock(size_t capacity) {
+        void* memory = ::operator new(HEADER_SIZE + capacity);
+        Block* block = static_cast<Block*>(memory);
+        block->next = nullptr;
+        block->capacity = capacity;
+        reserved_ += capacity;
+        return block;
+    }
+
+    // Переход к следующему блоку, в который поместится запрос.
+    // Слишком маленькие блоки после reset() пропускаются, новый
+    // блок вдвое больше предыдущего (но не меньше запроса).
+    void advance(size_t bytes, size_t alignment) {
+        size_t needed = bytes + alignment;
+        while (current_->next != nullptr) {
+            usedBefore_ += offset_;
+            current_ = current_->next;
+            offset_ = 0;
+            if (current_->capacity >= needed) {
+                return;
+            }
+        }
+
+        size_t capacity = current_->capacity * 2;
+        if (capacity < needed) {
+            capacity = needed;
+        }
+        current_->next = newBlock(capacity);
+        usedBefore_ += offset_;
+        current_ = current_->next;
+        offset_ = 0;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        size_t start = offset_ + paddingFor(offset_, alignment);
+        if (start + bytes > current_->capacity) {
+            advance(bytes, alignment);
+            start = paddingFor(0, alignment);
+        }
+        offset_ = start + bytes;
+        return blockData(current_) + start;
+    }
+
+    // Отдельные куски не освобождаются — только reset() целиком
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit MonotonicArena(size_t initialBlockSize = DEFAULT_BLOCK_SIZE)
+        : head_(nullptr), current_(nullptr), offset_(0), usedBefore_(0),
+          reserved_(0), initialBlockSize_(initialBlockSize == 0 ? 1 : initialBlockSize) {
+        head_ = newBlock(initialBlockSize_);
+        current_ = head_;
+    }
+
+    ~MonotonicArena() override {
+        Block* block = head_;
+        while (block != nullptr) {
+            Block* next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    // Всё выданное становится недействительным; объекты в арене
+    // к этому моменту должны быть уже разрушены
+    void reset() {
+        current_ = head_;
+        offset_ = 0;
+        usedBefore_ = 0;
+    }
+
+    // Сколько байт выдано с последнего reset() (с учётом выравнивания)
+    size_t bytesUsed() const { return usedBefore_ + offset_; }
+
+    // Сколько байт арена держит в блоках
+    size_t bytesReserved() const { return reserved_; }
+};
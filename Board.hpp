@@ -1,6 +1,8 @@
 // include/game/Board.hpp
 #pragma once
 #include "DynamicArray.hpp"
+#include "SmallArray.hpp"
+#include <cstdint>
 #include <iostream>
 #include <string>
 
@@ -26,19 +28,43 @@ struct Coord {
     }
 };
 
+// Список ходов: на полях до 10x10 целиком помещается в сам объект.
+// Полный список пустых клеток большого поля (до 19x19) уходит в кучу —
+// поиск там его не строит: ходы берутся только рядом с фишками
+// (MinimaxAI::setMoveRadius), их обычно меньше сотни
+using MoveList = SmallArray<Coord, 100>;
+
+// Самое большое поле, которое принимают меню, протокол и нотация
+const int MAX_BOARD_SIZE = 19;
+
 class Board {
 private:
     DynamicArray<CellState> cells_;
     int size_;
     int winLength_;
+    // Хеш Zobrist (XOR ключей занятых клеток) и число фишек ведутся
+    // в set(): hash() и isFull() не проходят по полю, что на 19x19
+    // в каждом узле поиска стоило бы сотни чтений
+    size_t hash_;
+    int stones_;
+
+    // Ключ клетки для фишки: splitmix64 от (клетка, цвет) — без таблицы,
+    // так что размер поля ничем не ограничен
+    static size_t zobristKey(int index, CellState state) {
+        if (state == CellState::Empty) {
+            return 0;
+        }
+        uint64_t z = static_cast<uint64_t>(index) * 2 + (state == CellState::X ? 1 : 2);
+        z = z * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<size_t>(z ^ (z >> 31));
+    }
 
 public:
     Board(int size = 3, int winLength = 3)
-        : size_(size), winLength_(winLength) {
-        cells_.reserve(size * size);
-        for (int i = 0; i < size * size; ++i) {
-            cells_.push_back(CellState::Empty);
-        }
+        : size_(size), winLength_(winLength), hash_(0), stones_(0) {
+        cells_.resize(size * size, CellState::Empty);
     }
 
     int getSize() const { return size_; }
@@ -59,7 +85,11 @@ public:
         if (row < 0 || row >= size_ || col < 0 || col >= size_) {
             throw std::out_of_range("Invalid coordinates");
         }
-        cells_[row * size_ + col] = state;
+        int index = row * size_ + col;
+        CellState& cell = cells_[index];
+        hash_ ^= zobristKey(index, cell) ^ zobristKey(index, state);
+        stones_ += (state != CellState::Empty) - (cell != CellState::Empty);
+        cell = state;
     }
 
     void set(const Coord& coord, CellState state) {
@@ -75,16 +105,15 @@ public:
     }
 
     bool isFull() const {
-        for (int i = 0; i < size_ * size_; ++i) {
-            if (cells_[i] == CellState::Empty) {
-                return false;
-            }
-        }
-        return true;
+        return stones_ == size_ * size_;
+    }
+
+    int stoneCount() const {
+        return stones_;
     }
 
-    DynamicArray<Coord> getEmptyCells() const {
-        DynamicArray<Coord> result;
+    MoveList getEmptyCells() const {
+        MoveList result;
         for (int row = 0; row < size_; ++row) {
             for (int col = 0; col < size_; ++col) {
                 if (isEmpty(row, col)) {
@@ -158,13 +187,38 @@ public:
         return false;
     }
 
+    // Собрала ли фишка в (row, col) линию. После хода выиграть мог
+    // только сходивший и только линией через его клетку, так что
+    // хватает четырёх линий вместо всего поля.
+    bool checkWinAt(int row, int col) const {
+        CellState player = get(row, col);
+        if (player == CellState::Empty) return false;
+
+        static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        for (const auto& dir : directions) {
+            int count = 1;
+            for (int sign = -1; sign <= 1; sign += 2) {
+                int r = row + sign * dir[0];
+                int c = col + sign * dir[1];
+                while (r >= 0 && r < size_ && c >= 0 && c < size_
+                       && cells_[r * size_ + c] == player) {
+                    ++count;
+                    r += sign * dir[0];
+                    c += sign * dir[1];
+                }
+            }
+            if (count >= winLength_) return true;
+        }
+        return false;
+    }
+
+    bool checkWinAt(const Coord& coord) const {
+        return checkWinAt(coord.row, coord.col);
+    }
+
     // Хеш для мемоизации
     size_t hash() const {
-        size_t h = 0;
-        for (int i = 0; i < size_ * size_; ++i) {
-            h = h * 3 + static_cast<int>(cells_[i]);
-        }
-        return h;
+        return hash_;
     }
 
     bool operator==(const Board& other) const {
@@ -175,30 +229,50 @@ public:
         return true;
     }
 
-    void print() const {
-        std::cout << "  ";
+    // Ширина номера строки в toString(): на полях больше 10x10 номера
+    // выравниваются по двузначным
+    int labelWidth() const {
+        return size_ > 10 ? 2 : 1;
+    }
+
+    // Поле в том виде, в каком его печатает print(): строка номеров
+    // столбцов (на больших полях — последняя цифра), строки клеток
+    // через строки-разделители
+    std::string toString() const {
+        std::string margin(static_cast<size_t>(labelWidth()) + 1, ' ');
+        std::string text = margin;
         for (int col = 0; col < size_; ++col) {
-            std::cout << col << " ";
+            text += std::to_string(col % 10);
+            text += ' ';
         }
-        std::cout << std::endl;
+        text += '\n';
 
         for (int row = 0; row < size_; ++row) {
-            std::cout << row << " ";
+            std::string label = std::to_string(row);
+            text.append(static_cast<size_t>(labelWidth()) - label.size(), ' ');
+            text += label;
+            text += ' ';
             for (int col = 0; col < size_; ++col) {
-                std::cout << static_cast<char>(get(row, col));
-                if (col < size_ - 1) std::cout << "|";
+                text += static_cast<char>(get(row, col));
+                if (col < size_ - 1) text += '|';
             }
-            std::cout << std::endl;
+            text += '\n';
 
             if (row < size_ - 1) {
-                std::cout << "  ";
+                text += margin;
                 for (int col = 0; col < size_; ++col) {
-                    std::cout << "-";
-                    if (col < size_ - 1) std::cout << "+";
+                    text += '-';
+                    if (col < size_ - 1) text += '+';
                 }
-                std::cout << std::endl;
+                text += '\n';
             }
         }
+        return text;
+    }
+
+    // Одна запись в поток вместо сброса буфера на каждой строке
+    void print() const {
+        std::cout << toString();
     }
 };
 
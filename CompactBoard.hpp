@@ -0,0 +1,216 @@
+// CompactBoard.hpp
+#pragma once
+#include "Board.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+// Доска фиксированной ёмкости (до 16x16) с клетками прямо в объекте.
+// Тривиально копируется (копия — это memcpy, без выделений памяти),
+// сравнивается memcmp и без опаски передаётся между потоками по значению.
+// Клетки за пределами size x size всегда пустые, поэтому два равных
+// поля совпадают побайтно.
+class CompactBoard {
+public:
+    static constexpr int MAX_SIZE = 16;
+
+private:
+    uint8_t size_;
+    uint8_t winLength_;
+    CellState cells_[MAX_SIZE * MAX_SIZE];
+
+    // Строки хранятся с шагом MAX_SIZE, а не size_: так индекс
+    // не зависит от размера поля
+    static int index(int row, int col) { return row * MAX_SIZE + col; }
+
+    bool inBounds(int row, int col) const {
+        return row >= 0 && row < size_ && col >= 0 && col < size_;
+    }
+
+    bool lineFrom(CellState player, int row, int col, int dRow, int dCol) const {
+        for (int k = 0; k < winLength_; ++k) {
+            if (cells_[index(row + k * dRow, col + k * dCol)] != player) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    CompactBoard(int size = 3, int winLength = 3) {
+        if (size <= 0 || size > MAX_SIZE || winLength <= 0 || winLength > size) {
+            throw std::invalid_argument("CompactBoard supports sizes up to 16x16");
+        }
+        size_ = static_cast<uint8_t>(size);
+        winLength_ = static_cast<uint8_t>(winLength);
+        std::memset(cells_, static_cast<int>(CellState::Empty), sizeof(cells_));
+    }
+
+    explicit CompactBoard(const Board& board)
+        : CompactBoard(board.getSize(), board.getWinLength()) {
+        for (int row = 0; row < size_; ++row) {
+            for (int col = 0; col < size_; ++col) {
+                cells_[index(row, col)] = board.get(row, col);
+            }
+        }
+    }
+
+    Board toBoard() const {
+        Board board(size_, winLength_);
+        for (int row = 0; row < size_; ++row) {
+            for (int col = 0; col < size_; ++col) {
+                board.set(row, col, cells_[index(row, col)]);
+            }
+        }
+        return board;
+    }
+
+    int getSize() const { return size_; }
+    int getWinLength() const { return winLength_; }
+
+    CellState get(int row, int col) const {
+        if (!inBounds(row, col)) {
+            throw std::out_of_range("Invalid coordinates");
+        }
+        return cells_[index(row, col)];
+    }
+
+    CellState get(const Coord& coord) const {
+        return get(coord.row, coord.col);
+    }
+
+    void set(int row, int col, CellState state) {
+        if (!inBounds(row, col)) {
+            throw std::out_of_range("Invalid coordinates");
+        }
+        cells_[index(row, col)] = state;
+    }
+
+    void set(const Coord& coord, CellState state) {
+        set(coord.row, coord.col, state);
+    }
+
+    bool isEmpty(int row, int col) const {
+        return get(row, col) == CellState::Empty;
+    }
+
+    bool isEmpty(const Coord& coord) const {
+        return isEmpty(coord.row, coord.col);
+    }
+
+    bool isFull() const {
+        for (int row = 0; row < size_; ++row) {
+            for (int col = 0; col < size_; ++col) {
+                if (cells_[index(row, col)] == CellState::Empty) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    MoveList getEmptyCells() const {
+        MoveList result;
+        for (int row = 0; row < size_; ++row) {
+            for (int col = 0; col < size_; ++col) {
+                if (cells_[index(row, col)] == CellState::Empty) {
+                    result.push_back(Coord(row, col));
+                }
+            }
+        }
+        return result;
+    }
+
+    // Та же проверка, что в Board::checkWin, но без проверок границ
+    bool checkWin(CellState player) const {
+        if (player == CellState::Empty) return false;
+
+        int last = size_ - winLength_;
+        for (int row = 0; row < size_; ++row) {
+            for (int col = 0; col <= last; ++col) {
+                if (lineFrom(player, row, col, 0, 1)) return true;
+            }
+        }
+        for (int row = 0; row <= last; ++row) {
+            for (int col = 0; col < size_; ++col) {
+                if (lineFrom(player, row, col, 1, 0)) return true;
+            }
+        }
+        for (int row = 0; row <= last; ++row) {
+            for (int col = 0; col <= last; ++col) {
+                if (lineFrom(player, row, col, 1, 1)) return true;
+            }
+            for (int col = winLength_ - 1; col < size_; ++col) {
+                if (lineFrom(player, row, col, 1, -1)) return true;
+            }
+        }
+        return false;
+    }
+
+    // Как Board::checkWinAt: только линии через клетку последнего хода
+    bool checkWinAt(int row, int col) const {
+        CellState player = cells_[index(row, col)];
+        if (player == CellState::Empty) return false;
+
+        static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        for (const auto& dir : directions) {
+            int count = 1;
+            for (int sign = -1; sign <= 1; sign += 2) {
+                int r = row + sign * dir[0];
+                int c = col + sign * dir[1];
+                while (r >= 0 && r < size_ && c >= 0 && c < size_
+                       && cells_[index(r, c)] == player) {
+                    ++count;
+                    r += sign * dir[0];
+                    c += sign * dir[1];
+                }
+            }
+            if (count >= winLength_) return true;
+        }
+        return false;
+    }
+
+    bool checkWinAt(const Coord& coord) const {
+        return checkWinAt(coord.row, coord.col);
+    }
+
+    // Хеш по машинным словам: используются только занятые строки поля
+    size_t hash() const {
+        uint64_t h = 0xcbf29ce484222325ULL ^ (static_cast<uint64_t>(size_) << 8) ^ winLength_;
+        size_t bytes = static_cast<size_t>(size_) * MAX_SIZE;
+        for (size_t offset = 0; offset < bytes; offset += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, reinterpret_cast<const unsigned char*>(cells_) + offset,
+                        sizeof(word));
+            h = (h ^ word) * 0x100000001b3ULL;
+            h ^= h >> 29;
+        }
+        return static_cast<size_t>(h);
+    }
+
+    bool operator==(const CompactBoard& other) const {
+        return std::memcmp(this, &other, sizeof(CompactBoard)) == 0;
+    }
+
+    bool operator!=(const CompactBoard& other) const {
+        return !(*this == other);
+    }
+};
+
+static_assert(std::is_trivially_copyable<CompactBoard>::value,
+              "CompactBoard must stay trivially copyable");
+static_assert(std::has_unique_object_representations<CompactBoard>::value,
+              "CompactBoard must have no padding for memcmp comparison");
+
+// Хеш-функция для std::hash<CompactBoard> (ключ HashMap)
+namespace std {
+    template<>
+    struct hash<CompactBoard> {
+        size_t operator()(const CompactBoard& board) const {
+            return board.hash();
+        }
+    };
+}
@@ -0,0 +1,130 @@
+// ConcurrentHashMap.hpp
+#pragma once
+#include "HashMap.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// Потокобезопасная хеш-таблица с разбиением на шарды (lock striping):
+// каждый шард — обычный HashMap под собственным мьютексом, шард выбирается
+// по старшим битам хеша. Потоки, работающие с разными шардами,
+// друг друга не блокируют.
+template<typename K, typename V>
+class ConcurrentHashMap {
+private:
+    // Выравнивание по кеш-линии, чтобы соседние мьютексы не делили линию
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        HashMap<K, V> map;
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    size_t shardCount_;
+    unsigned shardShift_;
+    std::hash<K> hasher_;
+
+    static constexpr size_t DEFAULT_SHARDS = 64;
+
+    // Старшие биты хеша: HashMap внутри шарда использует младшие
+    Shard& shardFor(const K& key) const {
+        uint64_t h = hashmap_detail::mix(static_cast<uint64_t>(hasher_(key)));
+        size_t index = shardCount_ == 1 ? 0 : static_cast<size_t>(h >> shardShift_);
+        return shards_[index];
+    }
+
+public:
+    explicit ConcurrentHashMap(size_t shardCount = DEFAULT_SHARDS)
+        : shardCount_(1), shardShift_(64) {
+        // Округляем число шардов вверх до степени двойки
+        while (shardCount_ < shardCount) {
+            shardCount_ *= 2;
+            --shardShift_;
+        }
+        shards_.reset(new Shard[shardCount_]);
+    }
+
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    void insert(const K& key, const V& value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map.insert_or_assign(key, value);
+    }
+
+    // true, если ключ был вставлен (а не перезаписан)
+    template<typename M>
+    bool insert_or_assign(const K& key, M&& value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.map.insert_or_assign(key, std::forward<M>(value)).second;
+    }
+
+    // true, если ключа не было и значение вставлено
+    template<typename... Args>
+    bool try_emplace(const K& key, Args&&... args) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.map.try_emplace(key, std::forward<Args>(args)...).second;
+    }
+
+    // Указатель наружу отдавать нельзя — значение копируется под блокировкой
+    bool find(const K& key, V& out) const {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (const V* value = shard.map.find(key)) {
+            out = *value;
+            return true;
+        }
+        return false;
+    }
+
+    bool contains(const K& key) const {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.map.contains(key);
+    }
+
+    // Атомарное чтение-изменение-запись значения по ключу:
+    // fn(V&) вызывается под блокировкой шарда
+    template<typename Fn>
+    bool update(const K& key, Fn&& fn) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (V* value = shard.map.find(key)) {
+            fn(*value);
+            return true;
+        }
+        return false;
+    }
+
+    void remove(const K& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map.remove(key);
+    }
+
+    // Размер — сумма по шардам; при параллельных изменениях приблизителен
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < shardCount_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            total += shards_[i].map.size();
+        }
+        return total;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t shardCount() const { return shardCount_; }
+
+    void clear() {
+        for (size_t i = 0; i < shardCount_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            shards_[i].map.clear();
+        }
+    }
+};
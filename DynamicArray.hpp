@@ -1,62 +1,106 @@
 // DynamicArray.hpp
 #pragma once
 #include <cstddef>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
 #include <utility>
 
+// Динамический массив поверх "сырой" памяти: элементы создаются
+// placement-new только при добавлении и разрушаются при удалении,
+// поэтому reserve не конструирует лишних объектов, а T не обязан
+// иметь конструктор по умолчанию или копирование.
+//
+// Память берётся из std::pmr::memory_resource (по умолчанию — обычная
+// куча), так что массив можно разместить, например, в арене поиска.
 template<typename T>
 class DynamicArray {
 private:
     T* data_;
     size_t size_;
     size_t capacity_;
+    std::pmr::memory_resource* resource_;
 
-    void resize(size_t newCapacity) {
-        T* newData = new T[newCapacity];
+    T* allocate(size_t capacity) {
+        if (capacity == 0) {
+            return nullptr;
+        }
+        return static_cast<T*>(resource_->allocate(sizeof(T) * capacity, alignof(T)));
+    }
+
+    void deallocate(T* data, size_t capacity) {
+        if (data != nullptr) {
+            resource_->deallocate(data, sizeof(T) * capacity, alignof(T));
+        }
+    }
+
+    void destroyRange(size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) {
+            data_[i].~T();
+        }
+    }
+
+    void reallocate(size_t newCapacity) {
+        T* newData = allocate(newCapacity);
         for (size_t i = 0; i < size_; ++i) {
-            newData[i] = std::move(data_[i]);
+            new (&newData[i]) T(std::move(data_[i]));
+            data_[i].~T();
         }
-        delete[] data_;
+        deallocate(data_, capacity_);
         data_ = newData;
         capacity_ = newCapacity;
     }
 
+    size_t grownCapacity() const {
+        return capacity_ == 0 ? 1 : capacity_ * 2;
+    }
+
 public:
-    DynamicArray() : data_(nullptr), size_(0), capacity_(0) {}
-    
-    explicit DynamicArray(size_t initialCapacity) 
-        : data_(new T[initialCapacity]), size_(0), capacity_(initialCapacity) {}
-    
+    DynamicArray()
+        : data_(nullptr), size_(0), capacity_(0),
+          resource_(std::pmr::get_default_resource()) {}
+
+    explicit DynamicArray(size_t initialCapacity,
+                          std::pmr::memory_resource& resource = *std::pmr::get_default_resource())
+        : data_(nullptr), size_(0), capacity_(initialCapacity), resource_(&resource) {
+        data_ = allocate(initialCapacity);
+    }
+
+    explicit DynamicArray(std::pmr::memory_resource& resource)
+        : data_(nullptr), size_(0), capacity_(0), resource_(&resource) {}
+
     ~DynamicArray() {
-        delete[] data_;
+        destroyRange(0, size_);
+        deallocate(data_, capacity_);
     }
 
-    // Copy constructor
-    DynamicArray(const DynamicArray& other) 
-        : data_(new T[other.capacity_]), size_(other.size_), capacity_(other.capacity_) {
-        for (size_t i = 0; i < size_; ++i) {
-            data_[i] = other.data_[i];
+    // Copy constructor: копия живёт в куче по умолчанию, а не в арене
+    // оригинала — её время жизни от арены не зависит
+    DynamicArray(const DynamicArray& other)
+        : DynamicArray(other, *std::pmr::get_default_resource()) {}
+
+    DynamicArray(const DynamicArray& other, std::pmr::memory_resource& resource)
+        : data_(nullptr), size_(0), capacity_(other.size_), resource_(&resource) {
+        data_ = allocate(capacity_);
+        for (; size_ < other.size_; ++size_) {
+            new (&data_[size_]) T(other.data_[size_]);
         }
     }
 
     // Move constructor
     DynamicArray(DynamicArray&& other) noexcept
-        : data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+        : data_(other.data_), size_(other.size_), capacity_(other.capacity_),
+          resource_(other.resource_) {
         other.data_ = nullptr;
         other.size_ = 0;
         other.capacity_ = 0;
     }
 
-    // Copy assignment
+    // Copy assignment: источник памяти остаётся прежним
     DynamicArray& operator=(const DynamicArray& other) {
         if (this != &other) {
-            delete[] data_;
-            data_ = new T[other.capacity_];
-            size_ = other.size_;
-            capacity_ = other.capacity_;
-            for (size_t i = 0; i < size_; ++i) {
-                data_[i] = other.data_[i];
-            }
+            DynamicArray copy(other, *resource_);
+            swap(copy);
         }
         return *this;
     }
@@ -64,36 +108,52 @@ public:
     // Move assignment
     DynamicArray& operator=(DynamicArray&& other) noexcept {
         if (this != &other) {
-            delete[] data_;
-            data_ = other.data_;
-            size_ = other.size_;
-            capacity_ = other.capacity_;
-            other.data_ = nullptr;
-            other.size_ = 0;
-            other.capacity_ = 0;
+            swap(other);
         }
         return *this;
     }
 
-    void push_back(const T& value) {
-        if (size_ >= capacity_) {
-            size_t newCapacity = capacity_ == 0 ? 1 : capacity_ * 2;
-            resize(newCapacity);
+    void swap(DynamicArray& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(resource_, other.resource_);
+    }
+
+    // Создаёт элемент прямо в массиве. При росте новый элемент строится
+    // до переноса старых: args могут ссылаться на элементы этого же массива.
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ < capacity_) {
+            new (&data_[size_]) T(std::forward<Args>(args)...);
+            return data_[size_++];
         }
-        data_[size_++] = value;
+
+        size_t newCapacity = grownCapacity();
+        T* newData = allocate(newCapacity);
+        new (&newData[size_]) T(std::forward<Args>(args)...);
+        for (size_t i = 0; i < size_; ++i) {
+            new (&newData[i]) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        deallocate(data_, capacity_);
+        data_ = newData;
+        capacity_ = newCapacity;
+        return data_[size_++];
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
     }
 
     void push_back(T&& value) {
-        if (size_ >= capacity_) {
-            size_t newCapacity = capacity_ == 0 ? 1 : capacity_ * 2;
-            resize(newCapacity);
-        }
-        data_[size_++] = std::move(value);
+        emplace_back(std::move(value));
     }
 
     void pop_back() {
         if (size_ > 0) {
             --size_;
+            data_[size_].~T();
         }
     }
 
@@ -111,22 +171,56 @@ public:
         return data_[index];
     }
 
+    T& back() { return (*this)[size_ - 1]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
     size_t size() const { return size_; }
     size_t capacity() const { return capacity_; }
     bool empty() const { return size_ == 0; }
-    
+
+    std::pmr::memory_resource* resource() const { return resource_; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
     T* begin() { return data_; }
     T* end() { return data_ + size_; }
     const T* begin() const { return data_; }
     const T* end() const { return data_ + size_; }
 
     void clear() {
+        destroyRange(0, size_);
         size_ = 0;
     }
 
     void reserve(size_t newCapacity) {
         if (newCapacity > capacity_) {
-            resize(newCapacity);
+            reallocate(newCapacity);
+        }
+    }
+
+    // Новые элементы создаются конструктором по умолчанию
+    void resize(size_t newSize) {
+        if (newSize <= size_) {
+            destroyRange(newSize, size_);
+            size_ = newSize;
+            return;
+        }
+        reserve(newSize);
+        for (; size_ < newSize; ++size_) {
+            new (&data_[size_]) T();
+        }
+    }
+
+    void resize(size_t newSize, const T& value) {
+        if (newSize <= size_) {
+            destroyRange(newSize, size_);
+            size_ = newSize;
+            return;
+        }
+        reserve(newSize);
+        for (; size_ < newSize; ++size_) {
+            new (&data_[size_]) T(value);
         }
     }
-};
\ No newline at end of file
+};
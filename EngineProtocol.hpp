@@ -0,0 +1,258 @@
+// EngineProtocol.hpp
+#pragma once
+#include "Board.hpp"
+#include "MinimaxAI.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Долгоживущий движок с построчным текстовым протоколом (по мотивам
+// Gomocup/UCI). Экземпляры MinimaxAI и их транспозиционные таблицы
+// живут весь сеанс: между ходами и между партиями таблица не
+// перестраивается. Поиск идёт в отдельном потоке, так что stop
+// и isready обрабатываются, пока движок думает.
+//
+// Команды (по одной на строку):
+//   newgame SIZE WIN        новая партия (таблицы движков сохраняются)
+//   position [R,C ...]      позиция: ходы от пустого поля, первым X
+//   go [time=MS] [depth=D]  поиск за сторону, чья очередь ходить
+//   stop                    прервать поиск и сразу ответить bestmove
+//   isready                 -> readyok
+//   quit                    выход (EOF — то же самое)
+// Ответы:
+//   ok | readyok | error TEXT
+//   bestmove R,C score=S depth=D nodes=N time=MS   (depth — завершённая)
+class EngineSession {
+private:
+    struct Engine {
+        int size;
+        int winLength;
+        Player player;
+        std::unique_ptr<MinimaxAI> ai;
+    };
+
+    std::istream& in_;
+    std::ostream& out_;
+    std::mutex outMutex_;
+
+    std::unique_ptr<Board> board_;
+    CellState toMove_;
+    std::vector<Engine> engines_;
+    size_t cacheLimit_;
+    int defaultDepth_;
+
+    std::thread searchThread_;
+    MinimaxAI* searching_;     // движок идущего поиска (nullptr — простой)
+    std::mutex searchMutex_;
+
+    void send(const std::string& line) {
+        std::lock_guard<std::mutex> lock(outMutex_);
+        out_ << line << '\n';
+        out_.flush();  // собеседник ждёт ответа построчно
+    }
+
+    // Движок на (поле, сторону) заводится один раз за сеанс
+    MinimaxAI& engineFor(int size, int winLength, Player player) {
+        for (Engine& engine : engines_) {
+            if (engine.size == size && engine.winLength == winLength
+                && engine.player == player) {
+                return *engine.ai;
+            }
+        }
+        Engine engine;
+        engine.size = size;
+        engine.winLength = winLength;
+        engine.player = player;
+        engine.ai.reset(new MinimaxAI(player, defaultDepth_, true));
+        engine.ai->setCacheLimit(cacheLimit_);
+        if (size >= LARGE_BOARD_MIN_SIZE) {
+            engine.ai->setLargeBoardMode();
+        }
+        engines_.push_back(std::move(engine));
+        return *engines_.back().ai;
+    }
+
+    void waitSearch() {
+        if (searchThread_.joinable()) {
+            searchThread_.join();
+        }
+    }
+
+    void stopSearch() {
+        std::lock_guard<std::mutex> lock(searchMutex_);
+        if (searching_ != nullptr) {
+            searching_->stop();
+        }
+    }
+
+    static bool parseCoord(const std::string& text, Coord& coord) {
+        size_t comma = text.find(',');
+        if (comma == std::string::npos || comma == 0 || comma + 1 >= text.size()) {
+            return false;
+        }
+        coord.row = std::atoi(text.c_str());
+        coord.col = std::atoi(text.c_str() + comma + 1);
+        return true;
+    }
+
+    void newGame(std::istringstream& args) {
+        int size = 0;
+        int winLength = 0;
+        if (!(args >> size >> winLength) || size < 3 || size > MAX_BOARD_SIZE
+            || winLength < 3 || winLength > size) {
+            send("error newgame SIZE WIN");
+            return;
+        }
+        board_.reset(new Board(size, winLength));
+        toMove_ = CellState::X;
+        send("ok");
+    }
+
+    void position(std::istringstream& args) {
+        if (!board_) {
+            send("error no game");
+            return;
+        }
+        Board board(board_->getSize(), board_->getWinLength());
+        CellState cell = CellState::X;
+        std::string token;
+        while (args >> token) {
+            Coord move;
+            if (!parseCoord(token, move) || move.row < 0 || move.row >= board.getSize()
+                || move.col < 0 || move.col >= board.getSize() || !board.isEmpty(move)) {
+                send("error bad move " + token);
+                return;
+            }
+            board.set(move, cell);
+            cell = cell == CellState::X ? CellState::O : CellState::X;
+        }
+        *board_ = board;
+        toMove_ = cell;
+        send("ok");
+    }
+
+    void go(std::istringstream& args) {
+        if (!board_) {
+            send("error no game");
+            return;
+        }
+        if (board_->getEmptyCells().empty() || board_->checkWin(CellState::X)
+            || board_->checkWin(CellState::O)) {
+            send("error game over");
+            return;
+        }
+
+        long long timeMs = 0;
+        int depth = defaultDepth_;
+        std::string token;
+        while (args >> token) {
+            if (token.compare(0, 5, "time=") == 0) {
+                timeMs = std::atoll(token.c_str() + 5);
+            } else if (token.compare(0, 6, "depth=") == 0) {
+                depth = std::atoi(token.c_str() + 6);
+            }
+        }
+        if (depth < 1) {
+            send("error bad depth");
+            return;
+        }
+
+        Player player = toMove_ == CellState::X ? Player::X : Player::O;
+        MinimaxAI& ai = engineFor(board_->getSize(), board_->getWinLength(), player);
+        ai.setMaxDepth(depth);
+        // stop от прошлого поиска, пришедший уже после его конца, не в счёт;
+        // stop, пришедший после этой строки, прервёт новый поиск
+        ai.clearStop();
+        {
+            std::lock_guard<std::mutex> lock(searchMutex_);
+            searching_ = &ai;
+        }
+
+        // У потока поиска своя копия позиции: главный поток тем временем
+        // читает команды и ничего не трогает в поиске, кроме stop()
+        Board board = *board_;
+        searchThread_ = std::thread([this, &ai, board, timeMs]() mutable {
+            MoveEvaluation eval = ai.findBestMoveTimed(board, std::chrono::milliseconds(timeMs));
+            {
+                std::lock_guard<std::mutex> lock(searchMutex_);
+                searching_ = nullptr;
+            }
+            const AIStatistics& stats = ai.getStatistics();
+            std::ostringstream line;
+            line << "bestmove " << eval.move.row << "," << eval.move.col
+                 << " score=" << eval.score
+                 << " depth=" << stats.depthReached
+                 << " nodes=" << stats.nodesVisited
+                 << " time=" << stats.timeMs;
+            send(line.str());
+        });
+    }
+
+public:
+    EngineSession(std::istream& in, std::ostream& out, int defaultDepth = 9,
+                  size_t cacheLimit = 1 << 19)
+        : in_(in),
+          out_(out),
+          toMove_(CellState::X),
+          cacheLimit_(cacheLimit),
+          defaultDepth_(defaultDepth),
+          searching_(nullptr) {}
+
+    ~EngineSession() {
+        stopSearch();
+        waitSearch();
+    }
+
+    EngineSession(const EngineSession&) = delete;
+    EngineSession& operator=(const EngineSession&) = delete;
+
+    // Читает команды до quit или конца ввода
+    void run() {
+        std::string line;
+        while (std::getline(in_, line)) {
+            std::istringstream args(line);
+            std::string command;
+            if (!(args >> command)) {
+                continue;
+            }
+
+            if (command == "isready") {
+                send("readyok");
+                continue;
+            }
+            if (command == "stop") {
+                stopSearch();
+                continue;
+            }
+            if (command == "quit") {
+                break;
+            }
+
+            // Остальные команды меняют позицию — дожидаемся поиска
+            waitSearch();
+            if (command == "newgame") {
+                newGame(args);
+            } else if (command == "position") {
+                position(args);
+            } else if (command == "go") {
+                go(args);
+            } else {
+                send("error unknown command " + command);
+            }
+        }
+        stopSearch();
+        waitSearch();
+    }
+
+    // Сколько движков заведено за сеанс (каждый со своей таблицей)
+    size_t engineCount() const {
+        return engines_.size();
+    }
+};
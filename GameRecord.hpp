@@ -0,0 +1,391 @@
+// GameRecord.hpp
+#pragma once
+#include "Board.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Компактный двоичный архив партий. Файл — заголовок и подряд идущие
+// записи, без индекса: дописывать можно в конец, читать — одним
+// последовательным проходом по отображённой в память области.
+//
+//   заголовок файла: "TTTR", версия (1 байт), 3 байта резерва
+//   запись:  size, winLength, result, flags   — по 1 байту
+//            moveCount                        — uint16, little-endian
+//            moves[moveCount]                 — row * size + col, 1 байт
+//            scores[moveCount]                — int16 LE, если flags & HAS_SCORES
+//
+// Первым ходит X. Поле не больше 16x16 — ход помещается в байт.
+// Оценка хода — с точки зрения сходившего (как её вернул его ИИ).
+namespace records {
+
+enum class Result : uint8_t {
+    Draw = 0,
+    XWins = 1,
+    OWins = 2,
+    Unfinished = 3
+};
+
+const char MAGIC[4] = {'T', 'T', 'T', 'R'};
+const uint8_t VERSION = 1;
+const size_t FILE_HEADER_SIZE = 8;
+const size_t RECORD_HEADER_SIZE = 6;
+const uint8_t HAS_SCORES = 1;
+const int MAX_SIZE = 16;
+
+inline const char* resultName(Result result) {
+    switch (result) {
+        case Result::Draw: return "draw";
+        case Result::XWins: return "X";
+        case Result::OWins: return "O";
+        case Result::Unfinished: break;
+    }
+    return "unfinished";
+}
+
+// Партия в памяти — то, что пишет Writer
+struct GameRecord {
+    uint8_t size;
+    uint8_t winLength;
+    Result result;
+    std::vector<uint8_t> moves;
+    std::vector<int16_t> scores;    // пусто — оценок нет
+
+    GameRecord() : size(3), winLength(3), result(Result::Unfinished) {}
+    GameRecord(int boardSize, int win)
+        : size(static_cast<uint8_t>(boardSize)),
+          winLength(static_cast<uint8_t>(win)),
+          result(Result::Unfinished) {}
+
+    // Оценка хода (случайного, человека) — 0; вне int16 обрезается
+    void addMove(const Coord& move, int score = 0) {
+        moves.push_back(static_cast<uint8_t>(move.row * size + move.col));
+        if (score > INT16_MAX) {
+            score = INT16_MAX;
+        } else if (score < INT16_MIN) {
+            score = INT16_MIN;
+        }
+        scores.push_back(static_cast<int16_t>(score));
+    }
+
+    void clear() {
+        moves.clear();
+        scores.clear();
+        result = Result::Unfinished;
+    }
+};
+
+// Запись архива без копирования: указатели в отображённый файл
+struct RecordView {
+    uint8_t size;
+    uint8_t winLength;
+    Result result;
+    uint16_t moveCount;
+    const uint8_t* moves;
+    const uint8_t* scores;          // nullptr — оценок нет
+
+    Coord move(size_t i) const {
+        return Coord(moves[i] / size, moves[i] % size);
+    }
+
+    bool hasScores() const { return scores != nullptr; }
+
+    int score(size_t i) const {
+        // Little-endian независимо от платформы, без невыровненного чтения
+        return static_cast<int16_t>(static_cast<uint16_t>(scores[2 * i])
+                                    | static_cast<uint16_t>(scores[2 * i + 1]) << 8);
+    }
+};
+
+// Дописывает партии в конец архива. Записи копятся в буфере
+// и уходят на диск пачками по FLUSH_BYTES и в деструкторе.
+class Writer {
+private:
+    static constexpr size_t FLUSH_BYTES = 1 << 16;
+
+    std::ofstream file_;
+    std::vector<uint8_t> buffer_;
+    size_t written_;
+
+    void put16(uint16_t value) {
+        buffer_.push_back(static_cast<uint8_t>(value & 0xFF));
+        buffer_.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+public:
+    explicit Writer(const std::string& filename)
+        : file_(filename, std::ios::out | std::ios::binary | std::ios::app),
+          written_(0) {
+        // Новый (пустой) файл начинается с заголовка
+        if (file_.is_open() && file_.tellp() == 0) {
+            buffer_.insert(buffer_.end(), MAGIC, MAGIC + 4);
+            buffer_.push_back(VERSION);
+            buffer_.insert(buffer_.end(), 3, 0);
+        }
+    }
+
+    ~Writer() { flush(); }
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    bool isOpen() const { return file_.is_open(); }
+    size_t recordsWritten() const { return written_; }
+
+    // false — поле больше MAX_SIZE: ход не помещается в байт, партия
+    // в архив не пишется
+    bool write(const GameRecord& record) {
+        if (record.size > MAX_SIZE) {
+            return false;
+        }
+        bool withScores = !record.scores.empty() && record.scores.size() == record.moves.size();
+        size_t count = record.moves.size() < 0xFFFF ? record.moves.size() : 0xFFFF;
+
+        buffer_.push_back(record.size);
+        buffer_.push_back(record.winLength);
+        buffer_.push_back(static_cast<uint8_t>(record.result));
+        buffer_.push_back(withScores ? HAS_SCORES : 0);
+        put16(static_cast<uint16_t>(count));
+        buffer_.insert(buffer_.end(), record.moves.begin(), record.moves.begin() + count);
+        if (withScores) {
+            for (size_t i = 0; i < count; ++i) {
+                put16(static_cast<uint16_t>(record.scores[i]));
+            }
+        }
+        ++written_;
+
+        if (buffer_.size() >= FLUSH_BYTES) {
+            flush();
+        }
+        return true;
+    }
+
+    void flush() {
+        if (!buffer_.empty() && file_.is_open()) {
+            file_.write(reinterpret_cast<const char*>(buffer_.data()),
+                        static_cast<std::streamsize>(buffer_.size()));
+            file_.flush();
+        }
+        buffer_.clear();
+    }
+};
+
+// Архив только для чтения. Файл отображается в память (mmap,
+// на Windows — MapViewOfFile); если отобразить не вышло, он читается
+// в буфер целиком. Записи разбираются на лету при обходе.
+class Archive {
+private:
+    const uint8_t* data_;
+    size_t size_;
+    std::vector<uint8_t> fallback_;
+    std::string error_;
+    bool truncated_;
+    void* mapped_;      // отображение файла (nullptr — буфер fallback_)
+#ifdef _WIN32
+    HANDLE file_;
+    HANDLE mapping_;
+#endif
+
+    bool readWhole(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            error_ = "не удалось открыть " + filename;
+            return false;
+        }
+        fallback_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+        return true;
+    }
+
+    bool map(const std::string& filename) {
+#ifdef _WIN32
+        file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0) {
+            return false;
+        }
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr) {
+            return false;
+        }
+        mapped_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        if (mapped_ == nullptr) {
+            return false;
+        }
+        data_ = static_cast<const uint8_t*>(mapped_);
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                            MAP_PRIVATE, fd, 0);
+        ::close(fd);  // отображение живёт и без дескриптора
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        // Читаем строго подряд: пусть ядро читает вперёд крупно
+        madvise(mapped, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+        mapped_ = mapped;
+        data_ = static_cast<const uint8_t*>(mapped);
+        size_ = static_cast<size_t>(info.st_size);
+        return true;
+#endif
+    }
+
+public:
+    Archive()
+        : data_(nullptr), size_(0), truncated_(false), mapped_(nullptr)
+#ifdef _WIN32
+        , file_(INVALID_HANDLE_VALUE), mapping_(nullptr)
+#endif
+    {}
+
+    ~Archive() { close(); }
+
+    Archive(const Archive&) = delete;
+    Archive& operator=(const Archive&) = delete;
+
+    bool open(const std::string& filename) {
+        close();
+        error_.clear();
+        if (!map(filename)) {
+            close();
+            if (!readWhole(filename)) {
+                return false;
+            }
+        }
+        if (size_ < FILE_HEADER_SIZE || std::memcmp(data_, MAGIC, 4) != 0) {
+            error_ = filename + ": не архив партий";
+            close();
+            return false;
+        }
+        if (data_[4] != VERSION) {
+            error_ = filename + ": неизвестная версия формата";
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (mapped_ != nullptr) {
+            UnmapViewOfFile(mapped_);
+            mapped_ = nullptr;
+        }
+        if (mapping_ != nullptr) {
+            CloseHandle(mapping_);
+            mapping_ = nullptr;
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (mapped_ != nullptr) {
+            munmap(mapped_, size_);
+            mapped_ = nullptr;
+        }
+#endif
+        fallback_.clear();
+        data_ = nullptr;
+        size_ = 0;
+        truncated_ = false;
+    }
+
+    bool isOpen() const { return data_ != nullptr; }
+    size_t bytes() const { return size_; }
+    const std::string& error() const { return error_; }
+
+    // Файл оборвался посреди записи (например, запись шла при падении)
+    bool truncated() const { return truncated_; }
+
+    // Вызывает visit(const RecordView&) для каждой записи по порядку;
+    // возвращает число записей. Оборванная последняя запись пропускается.
+    template<typename F>
+    size_t forEach(F visit) {
+        size_t count = 0;
+        size_t pos = FILE_HEADER_SIZE;
+        truncated_ = false;
+        while (pos < size_) {
+            if (size_ - pos < RECORD_HEADER_SIZE) {
+                truncated_ = true;
+                break;
+            }
+            const uint8_t* p = data_ + pos;
+            RecordView view;
+            view.size = p[0];
+            view.winLength = p[1];
+            view.result = static_cast<Result>(p[2]);
+            view.moveCount = static_cast<uint16_t>(p[4] | p[5] << 8);
+            bool withScores = (p[3] & HAS_SCORES) != 0;
+            size_t length = RECORD_HEADER_SIZE + view.moveCount * (withScores ? 3u : 1u);
+            if (size_ - pos < length || view.size == 0 || view.size > MAX_SIZE) {
+                truncated_ = true;
+                break;
+            }
+            view.moves = p + RECORD_HEADER_SIZE;
+            view.scores = withScores ? view.moves + view.moveCount : nullptr;
+            visit(static_cast<const RecordView&>(view));
+            ++count;
+            pos += length;
+        }
+        return count;
+    }
+};
+
+// Проигрывает партию на доске (любой с интерфейсом Board: get/set,
+// checkWin, isFull). false — ход в занятую клетку, ходы после конца
+// партии или итог, не совпавший с записанным.
+template<typename B>
+bool replay(const RecordView& record, B& board) {
+    Result actual = Result::Unfinished;
+    for (size_t i = 0; i < record.moveCount; ++i) {
+        if (actual != Result::Unfinished || record.moves[i] >= record.size * record.size) {
+            return false;
+        }
+        Coord move = record.move(i);
+        if (board.get(move) != CellState::Empty) {
+            return false;
+        }
+        CellState cell = i % 2 == 0 ? CellState::X : CellState::O;
+        board.set(move, cell);
+        if (board.checkWin(cell)) {
+            actual = cell == CellState::X ? Result::XWins : Result::OWins;
+        } else if (board.isFull()) {
+            actual = Result::Draw;
+        }
+    }
+    return actual == record.result;
+}
+
+} // namespace records
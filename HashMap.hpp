@@ -1,151 +1,1126 @@
 // HashMap.hpp
 #pragma once
-#include "DynamicArray.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <memory_resource>
+#include <new>
 #include <utility>
 #include <stdexcept>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HASHMAP_USE_SSE2 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace hashmap_detail {
+
+    // Управляющий байт слота: старший бит = 1 — слот свободен,
+    // иначе младшие 7 бит — фрагмент хеша (H2) ключа в этом слоте.
+    constexpr int8_t kEmpty = -128;   // 0b10000000
+    constexpr int8_t kDeleted = -2;   // 0b11111110 (надгробие)
+
+    // Размер группы: столько управляющих байт сравнивается за одну инструкцию
+    constexpr size_t kGroupWidth = 16;
+
+    inline unsigned countTrailingZeros(uint32_t mask) {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+    #else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+    #endif
+    }
+
+    // Перемешивание хеша: std::hash для целых — тождественная функция,
+    // а нам нужны "случайные" и старшие (H1), и младшие (H2) биты.
+    inline uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Группа из 16 управляющих байт. Каждый match* возвращает битовую
+    // маску: i-й бит установлен, если i-й слот группы подходит.
+    class Group {
+    private:
+    #ifdef HASHMAP_USE_SSE2
+        __m128i ctrl_;
+    #else
+        const int8_t* ctrl_;
+    #endif
+
+    public:
+        explicit Group(const int8_t* ctrl)
+    #ifdef HASHMAP_USE_SSE2
+            : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+    #else
+            : ctrl_(ctrl) {}
+    #endif
+
+        uint32_t match(int8_t h2) const {
+        #ifdef HASHMAP_USE_SSE2
+            return static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(h2))));
+        #else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < kGroupWidth; ++i) {
+                if (ctrl_[i] == h2) mask |= 1u << i;
+            }
+            return mask;
+        #endif
+        }
+
+        uint32_t matchEmpty() const {
+            return match(kEmpty);
+        }
+
+        // Пустые и удалённые слоты — ровно те, у кого установлен знаковый бит
+        uint32_t matchEmptyOrDeleted() const {
+        #ifdef HASHMAP_USE_SSE2
+            return static_cast<uint32_t>(_mm_movemask_epi8(ctrl_));
+        #else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < kGroupWidth; ++i) {
+                if (ctrl_[i] < 0) mask |= 1u << i;
+            }
+            return mask;
+        #endif
+        }
+    };
+
+} // namespace hashmap_detail
+
+// Сбор статистики пробирования и рехешей включается на этапе компиляции
+// (-DHASHMAP_STATS); без него счётчики и замеры времени не компилируются.
+#ifdef HASHMAP_STATS
+#define HASHMAP_STATS_ONLY(...) __VA_ARGS__
+#else
+#define HASHMAP_STATS_ONLY(...)
+#endif
+
+// Снимок состояния таблицы. Размер, надгробия, загрузка и память
+// доступны всегда; гистограммы и рехеши — только с HASHMAP_STATS.
+struct HashMapStats {
+    // Длина пробирования — число просмотренных групп по 16 слотов;
+    // последняя корзина — "столько и больше"
+    static constexpr size_t PROBE_BUCKETS = 8;
+
+    bool detailed;
+    size_t hitProbes[PROBE_BUCKETS];
+    size_t missProbes[PROBE_BUCKETS];
+    size_t rehashCount;
+    long long rehashTimeNs;      // включая шаги инкрементального переноса
+
+    size_t size;
+    size_t capacity;
+    size_t tombstones;
+    double loadFactor;           // size / capacity
+    double effectiveLoadFactor;  // (size + tombstones) / capacity
+    size_t bytesAllocated;
+
+    HashMapStats()
+        : detailed(false), hitProbes(), missProbes(), rehashCount(0), rehashTimeNs(0),
+          size(0), capacity(0), tombstones(0), loadFactor(0.0),
+          effectiveLoadFactor(0.0), bytesAllocated(0) {}
+
+    void resetCounters() {
+        for (size_t i = 0; i < PROBE_BUCKETS; ++i) {
+            hitProbes[i] = 0;
+            missProbes[i] = 0;
+        }
+        rehashCount = 0;
+        rehashTimeNs = 0;
+    }
+
+    void recordProbe(bool hit, size_t groups) {
+        size_t bucket = groups < PROBE_BUCKETS ? groups - 1 : PROBE_BUCKETS - 1;
+        ++(hit ? hitProbes : missProbes)[bucket];
+    }
+
+    static double averageProbe(const size_t* histogram) {
+        size_t count = 0;
+        size_t total = 0;
+        for (size_t i = 0; i < PROBE_BUCKETS; ++i) {
+            count += histogram[i];
+            total += histogram[i] * (i + 1);
+        }
+        return count > 0 ? static_cast<double>(total) / static_cast<double>(count) : 0.0;
+    }
+
+    double averageHitProbe() const { return averageProbe(hitProbes); }
+    double averageMissProbe() const { return averageProbe(missProbes); }
+};
+
+// Хеш-таблица с открытой адресацией в стиле Swiss table:
+// отдельный массив управляющих байт (7 бит хеша на слот), ёмкость —
+// степень двойки, пробирование группами по 16 слотов.
 template<typename K, typename V>
 class HashMap {
-private:
+public:
+    // Элемент таблицы; при обходе ключ менять нельзя
     struct Entry {
         K key;
         V value;
-        bool occupied;
-        bool deleted;
+    };
 
-        Entry() : occupied(false), deleted(false) {}
-        Entry(const K& k, const V& v) : key(k), value(v), occupied(true), deleted(false) {}
+    // Наблюдатель перестроек: begin зовётся перед рехешем, началом или
+    // завершением переноса и чисткой надгробий (имя операции и новая
+    // ёмкость), end — после. Сама таблица ничего не трассирует: MinimaxAI
+    // вешает сюда отрезки Tracer. Нужны функции без состояния — хук
+    // копируется вместе с таблицей.
+    struct RehashHook {
+        void (*begin)(const char* operation, size_t capacity);
+        void (*end)();
     };
 
-    DynamicArray<Entry> table_;
+private:
+    int8_t* ctrl_;
+    Entry* slots_;
     size_t size_;
+    size_t deleted_;
     size_t capacity_;
     std::hash<K> hasher_;
 
-    static constexpr double MAX_LOAD_FACTOR = 0.7;
+    // Источник памяти для всех массивов таблицы (по умолчанию — куча)
+    std::pmr::memory_resource* resource_;
+
+    // Ограниченный режим (кеш с фиксированным потолком памяти):
+    // при maxEntries_ > 0 таблица не растёт, а вытесняет элементы по
+    // алгоритму CLOCK (second chance). refBits_ — бит обращения на слот,
+    // hand_ — позиция "стрелки часов".
+    size_t maxEntries_;
+    uint8_t* refBits_;
+    size_t hand_;
+    size_t evictions_;
+
+    // Инкрементальный рехеш: при росте старая таблица (old*) живёт рядом
+    // с новой, и каждая изменяющая операция переносит в новую несколько
+    // групп, начиная с migrateCursor_. oldSize_ — сколько элементов ещё
+    // осталось в старой таблице (они входят в size_).
+    bool incremental_;
+    int8_t* oldCtrl_;
+    Entry* oldSlots_;
+    size_t oldCapacity_;
+    size_t oldSize_;
+    size_t migrateCursor_;
+
+    RehashHook rehashHook_;
+
+#ifdef HASHMAP_STATS
+    mutable HashMapStats counters_;
+#endif
+
     static constexpr size_t INITIAL_CAPACITY = 16;
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+    static constexpr size_t MIGRATE_GROUPS_PER_OP = 2;
 
-    size_t hash(const K& key) const {
-        return hasher_(key) % capacity_;
+    // Максимальная загрузка (с учётом надгробий) — 7/8
+    static size_t maxLoad(size_t capacity) {
+        return capacity - capacity / 8;
     }
 
-    size_t probe(size_t index, size_t i) const {
-        return (index + i) % capacity_;
+    // Вызов хука на время одной перестройки
+    class RehashScope {
+    private:
+        const RehashHook& hook_;
+
+    public:
+        RehashScope(const RehashHook& hook, const char* operation, size_t capacity)
+            : hook_(hook) {
+            if (hook_.begin != nullptr) {
+                hook_.begin(operation, capacity);
+            }
+        }
+
+        ~RehashScope() {
+            if (hook_.end != nullptr) {
+                hook_.end();
+            }
+        }
+
+        RehashScope(const RehashScope&) = delete;
+        RehashScope& operator=(const RehashScope&) = delete;
+    };
+
+    uint64_t hashOf(const K& key) const {
+        return hashmap_detail::mix(static_cast<uint64_t>(hasher_(key)));
     }
 
-    void rehash() {
-        size_t oldCapacity = capacity_;
-        DynamicArray<Entry> oldTable = std::move(table_);
-        
-        capacity_ = oldCapacity * 2;
-        table_ = DynamicArray<Entry>(capacity_);
-        for (size_t i = 0; i < capacity_; ++i) {
-            table_.push_back(Entry());
+    static size_t h1(uint64_t h) { return static_cast<size_t>(h >> 7); }
+    static int8_t h2(uint64_t h) { return static_cast<int8_t>(h & 0x7F); }
+
+    // Группы выровнены по 16 слотов и не переходят через конец таблицы.
+    // Шаг пробирования растёт на 1 (треугольные числа), что при числе групп,
+    // равном степени двойки, обходит все группы.
+    size_t findIndexIn(const int8_t* ctrl, const Entry* slots,
+                       size_t capacity, const K& key, uint64_t h) const {
+        using namespace hashmap_detail;
+        const int8_t tag = h2(h);
+        const size_t mask = capacity / kGroupWidth - 1;
+        size_t group = h1(h) & mask;
+
+        for (size_t step = 0; step <= mask; ++step) {
+            const size_t base = group * kGroupWidth;
+            Group g(ctrl + base);
+
+            for (uint32_t m = g.match(tag); m != 0; m &= m - 1) {
+                size_t index = base + countTrailingZeros(m);
+                if (slots[index].key == key) {
+                    HASHMAP_STATS_ONLY(counters_.recordProbe(true, step + 1);)
+                    return index;
+                }
+            }
+
+            // Пустой слот в группе: дальше ключ искать бессмысленно
+            if (g.matchEmpty() != 0) {
+                HASHMAP_STATS_ONLY(counters_.recordProbe(false, step + 1);)
+                return NOT_FOUND;
+            }
+            group = (group + step + 1) & mask;
         }
-        size_ = 0;
+        return NOT_FOUND;
+    }
 
-        for (size_t i = 0; i < oldCapacity; ++i) {
-            if (oldTable[i].occupied && !oldTable[i].deleted) {
-                insert(oldTable[i].key, oldTable[i].value);
+    size_t findIndex(const K& key, uint64_t h) const {
+        return findIndexIn(ctrl_, slots_, capacity_, key, h);
+    }
+
+    // Первый свободный (пустой или удалённый) слот на пути пробирования
+    size_t findInsertIndex(uint64_t h) const {
+        using namespace hashmap_detail;
+        const size_t mask = capacity_ / kGroupWidth - 1;
+        size_t group = h1(h) & mask;
+
+        for (size_t step = 0; step <= mask; ++step) {
+            const size_t base = group * kGroupWidth;
+            uint32_t m = Group(ctrl_ + base).matchEmptyOrDeleted();
+            if (m != 0) {
+                return base + countTrailingZeros(m);
             }
+            group = (group + step + 1) & mask;
         }
+        return NOT_FOUND;
     }
 
-public:
-    HashMap() : size_(0), capacity_(INITIAL_CAPACITY) {
-        table_ = DynamicArray<Entry>(capacity_);
-        for (size_t i = 0; i < capacity_; ++i) {
-            table_.push_back(Entry());
+    // Один проход по цепочке: либо индекс найденного ключа (found = true),
+    // либо первый свободный слот, куда ключ можно вставить.
+    size_t findOrPrepareInsert(const K& key, uint64_t h, bool& found) const {
+        using namespace hashmap_detail;
+        const int8_t tag = h2(h);
+        const size_t mask = capacity_ / kGroupWidth - 1;
+        size_t group = h1(h) & mask;
+        size_t firstFree = NOT_FOUND;
+
+        for (size_t step = 0; step <= mask; ++step) {
+            const size_t base = group * kGroupWidth;
+            Group g(ctrl_ + base);
+
+            for (uint32_t m = g.match(tag); m != 0; m &= m - 1) {
+                size_t index = base + countTrailingZeros(m);
+                if (slots_[index].key == key) {
+                    HASHMAP_STATS_ONLY(counters_.recordProbe(true, step + 1);)
+                    found = true;
+                    return index;
+                }
+            }
+
+            if (firstFree == NOT_FOUND) {
+                uint32_t free = g.matchEmptyOrDeleted();
+                if (free != 0) {
+                    firstFree = base + countTrailingZeros(free);
+                }
+            }
+            if (g.matchEmpty() != 0) {
+                HASHMAP_STATS_ONLY(counters_.recordProbe(false, step + 1);)
+                break;
+            }
+            group = (group + step + 1) & mask;
         }
+
+        found = false;
+        return firstFree;
     }
 
-    void insert(const K& key, const V& value) {
-        if (static_cast<double>(size_) / capacity_ >= MAX_LOAD_FACTOR) {
-            rehash();
+    // Поиск в обеих таблицах (во время миграции ключ может быть в старой)
+    Entry* lookup(const K& key) const {
+        uint64_t h = hashOf(key);
+        size_t index = findIndex(key, h);
+        if (index != NOT_FOUND) {
+            touch(index);
+            return &slots_[index];
+        }
+        if (oldCtrl_ != nullptr) {
+            index = findIndexIn(oldCtrl_, oldSlots_, oldCapacity_, key, h);
+            if (index != NOT_FOUND) {
+                return &oldSlots_[index];
+            }
         }
+        return nullptr;
+    }
 
-        size_t index = hash(key);
-        for (size_t i = 0; i < capacity_; ++i) {
-            size_t pos = probe(index, i);
-            Entry& entry = table_[pos];
+    void allocate(size_t capacity) {
+        capacity_ = capacity;
+        ctrl_ = static_cast<int8_t*>(
+            resource_->allocate(capacity_, hashmap_detail::kGroupWidth));
+        std::memset(ctrl_, hashmap_detail::kEmpty, capacity_);
+        slots_ = static_cast<Entry*>(
+            resource_->allocate(sizeof(Entry) * capacity_, alignof(Entry)));
+    }
+
+    void freeTable(int8_t* ctrl, Entry* slots, size_t capacity) {
+        if (ctrl != nullptr) {
+            resource_->deallocate(ctrl, capacity, hashmap_detail::kGroupWidth);
+            resource_->deallocate(slots, sizeof(Entry) * capacity, alignof(Entry));
+        }
+    }
+
+    uint8_t* allocateRefBits(size_t capacity) {
+        uint8_t* bits = static_cast<uint8_t*>(resource_->allocate(capacity, 1));
+        std::memset(bits, 0, capacity);
+        return bits;
+    }
 
-            if (!entry.occupied || entry.deleted) {
-                entry = Entry(key, value);
-                ++size_;
-                return;
+    void freeRefBits(uint8_t* bits, size_t capacity) {
+        if (bits != nullptr) {
+            resource_->deallocate(bits, capacity, 1);
+        }
+    }
+
+    static void destroyTable(const int8_t* ctrl, Entry* slots, size_t capacity) {
+        for (size_t i = 0; i < capacity; ++i) {
+            if (ctrl[i] >= 0) {
+                slots[i].~Entry();
             }
+        }
+    }
 
-            if (entry.key == key) {
-                entry.value = value;
-                return;
+    void destroySlots() {
+        destroyTable(ctrl_, slots_, capacity_);
+        if (oldCtrl_ != nullptr) {
+            destroyTable(oldCtrl_, oldSlots_, oldCapacity_);
+        }
+    }
+
+    void deallocate() {
+        freeTable(ctrl_, slots_, capacity_);
+        freeRefBits(refBits_, capacity_);
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        refBits_ = nullptr;
+        releaseOldTable();
+    }
+
+    void releaseOldTable() {
+        freeTable(oldCtrl_, oldSlots_, oldCapacity_);
+        oldCtrl_ = nullptr;
+        oldSlots_ = nullptr;
+        oldCapacity_ = 0;
+        oldSize_ = 0;
+        migrateCursor_ = 0;
+    }
+
+    void touch(size_t index) const {
+        if (refBits_ != nullptr) {
+            refBits_[index] = 1;
+        }
+    }
+
+    // Пометка освободившегося слота. Если в группе уже есть пустой слот,
+    // ни одна цепочка через неё не проходит — можно сразу пометить слот
+    // пустым, без надгробия
+    static bool markFree(int8_t* ctrl, size_t index) {
+        using namespace hashmap_detail;
+        size_t base = index & ~(kGroupWidth - 1);
+        if (Group(ctrl + base).matchEmpty() != 0) {
+            ctrl[index] = kEmpty;
+            return false;
+        }
+        ctrl[index] = kDeleted;
+        return true;
+    }
+
+    void eraseAt(size_t index) {
+        slots_[index].~Entry();
+        --size_;
+        if (markFree(ctrl_, index)) {
+            ++deleted_;
+        }
+    }
+
+    void eraseOldAt(size_t index) {
+        oldSlots_[index].~Entry();
+        --size_;
+        --oldSize_;
+        markFree(oldCtrl_, index);
+    }
+
+    // CLOCK: стрелка обходит слоты; элемент с битом обращения получает
+    // второй шанс (бит сбрасывается), первый элемент без бита вытесняется
+    void evictOne() {
+        while (true) {
+            size_t index = hand_;
+            hand_ = (hand_ + 1) & (capacity_ - 1);
+            if (ctrl_[index] < 0) {
+                continue;
+            }
+            if (refBits_[index] != 0) {
+                refBits_[index] = 0;
+                continue;
             }
+            eraseAt(index);
+            ++evictions_;
+            return;
         }
     }
 
-    bool contains(const K& key) const {
-        size_t index = hash(key);
-        for (size_t i = 0; i < capacity_; ++i) {
-            size_t pos = probe(index, i);
-            const Entry& entry = table_[pos];
+    // Предельная ёмкость ограниченного режима: запас вдвое, чтобы после
+    // её достижения очистка надгробий всегда шла на месте
+    static size_t boundedCapacity(size_t maxEntries) {
+        size_t capacity = INITIAL_CAPACITY;
+        while (maxLoad(capacity) / 2 < maxEntries) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // Вставка заведомо отсутствующего ключа в текущую таблицу
+    size_t placeEntry(Entry&& entry, uint64_t h) {
+        size_t index = findInsertIndex(h);
+        if (ctrl_[index] == hashmap_detail::kDeleted) {
+            --deleted_;
+        }
+        ctrl_[index] = h2(h);
+        new (&slots_[index]) Entry{std::move(entry.key), std::move(entry.value)};
+        return index;
+    }
+
+    void rehash(size_t newCapacity) {
+        finishMigration();
+        RehashScope scope(rehashHook_, "HashMap::rehash", newCapacity);
+        HASHMAP_STATS_ONLY(auto rehashStart = std::chrono::steady_clock::now();)
+
+        int8_t* oldCtrl = ctrl_;
+        Entry* oldSlots = slots_;
+        uint8_t* oldRefBits = refBits_;
+        size_t oldCapacity = capacity_;
 
-            if (!entry.occupied) {
-                return false;
+        allocate(newCapacity);
+        refBits_ = nullptr;
+        if (maxEntries_ > 0) {
+            refBits_ = allocateRefBits(capacity_);
+        }
+        deleted_ = 0;
+
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] >= 0) {
+                size_t index = placeEntry(std::move(oldSlots[i]), hashOf(oldSlots[i].key));
+                oldSlots[i].~Entry();
+                if (refBits_ != nullptr && oldRefBits != nullptr) {
+                    refBits_[index] = oldRefBits[i];
+                }
             }
+        }
+
+        freeTable(oldCtrl, oldSlots, oldCapacity);
+        freeRefBits(oldRefBits, oldCapacity);
+        hand_ &= capacity_ - 1;
+
+        HASHMAP_STATS_ONLY(
+            ++counters_.rehashCount;
+            counters_.rehashTimeNs += elapsedNs(rehashStart);
+        )
+    }
+
+#ifdef HASHMAP_STATS
+    static long long elapsedNs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+#endif
 
-            if (entry.occupied && !entry.deleted && entry.key == key) {
-                return true;
+    // Начало инкрементального рехеша: текущая таблица становится старой.
+    // В ограниченном режиме сюда попадает только рост ниже потолка, так
+    // что обе таблицы вместе не больше предельной (или, на последнем
+    // росте, полторы её — это учтено в setMemoryBudget)
+    void startMigration(size_t newCapacity) {
+        RehashScope scope(rehashHook_, "HashMap::startMigration", newCapacity);
+        HASHMAP_STATS_ONLY(++counters_.rehashCount;)
+        oldCtrl_ = ctrl_;
+        oldSlots_ = slots_;
+        oldCapacity_ = capacity_;
+        oldSize_ = size_;
+        migrateCursor_ = 0;
+
+        allocate(newCapacity);
+        deleted_ = 0;
+
+        // Биты обращения перенесённых элементов сбрасываются: это лишь
+        // лишает их второго шанса CLOCK в ближайшем обходе
+        if (refBits_ != nullptr) {
+            freeRefBits(refBits_, oldCapacity_);
+            refBits_ = allocateRefBits(capacity_);
+            hand_ &= capacity_ - 1;
+        }
+    }
+
+    size_t moveFromOld(size_t oldIndex, uint64_t h) {
+        size_t index = placeEntry(std::move(oldSlots_[oldIndex]), h);
+        oldSlots_[oldIndex].~Entry();
+        // В старой таблице только надгробия: цепочки других ключей
+        // через этот слот должны остаться целыми
+        oldCtrl_[oldIndex] = hashmap_detail::kDeleted;
+        --oldSize_;
+        return index;
+    }
+
+    // Перенос очередных MIGRATE_GROUPS_PER_OP групп старой таблицы
+    void migrateStep() {
+        if (oldCtrl_ == nullptr) {
+            return;
+        }
+        HASHMAP_STATS_ONLY(auto stepStart = std::chrono::steady_clock::now();)
+
+        size_t end = migrateCursor_ + MIGRATE_GROUPS_PER_OP * hashmap_detail::kGroupWidth;
+        if (end > oldCapacity_) {
+            end = oldCapacity_;
+        }
+        for (; migrateCursor_ < end && oldSize_ > 0; ++migrateCursor_) {
+            if (oldCtrl_[migrateCursor_] >= 0) {
+                moveFromOld(migrateCursor_, hashOf(oldSlots_[migrateCursor_].key));
             }
         }
-        return false;
+        if (oldSize_ == 0 || migrateCursor_ >= oldCapacity_) {
+            releaseOldTable();
+        }
+        HASHMAP_STATS_ONLY(counters_.rehashTimeNs += elapsedNs(stepStart);)
     }
 
-    V& get(const K& key) {
-        size_t index = hash(key);
+    void finishMigration() {
+        if (oldCtrl_ == nullptr) {
+            return;
+        }
+        RehashScope scope(rehashHook_, "HashMap::finishMigration", capacity_);
+        while (oldCtrl_ != nullptr) {
+            migrateStep();
+        }
+    }
+
+    // Очистка надгробий внутри того же массива, без второй таблицы.
+    // Сначала надгробия становятся пустыми слотами, а занятые слоты —
+    // надгробиями со значением «ждёт переноса». Затем каждый такой
+    // элемент ставится в первый свободный слот своей цепочки: если это
+    // его же группа, он остаётся на месте; если пустой слот — переезжает;
+    // если чужой «ждущий» — они меняются местами, и слот разбирается
+    // заново. Группы перед местом элемента в его цепочке к этому моменту
+    // заняты целиком, так что поиск до него доходит.
+    void dropTombstones() {
+        using namespace hashmap_detail;
+        RehashScope scope(rehashHook_, "HashMap::dropTombstones", capacity_);
+        HASHMAP_STATS_ONLY(auto rehashStart = std::chrono::steady_clock::now();)
+
         for (size_t i = 0; i < capacity_; ++i) {
-            size_t pos = probe(index, i);
-            Entry& entry = table_[pos];
+            ctrl_[i] = ctrl_[i] >= 0 ? kDeleted : kEmpty;
+        }
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] != kDeleted) {
+                continue;
+            }
+            uint64_t h = hashOf(slots_[i].key);
+            size_t target = findInsertIndex(h);
+            if (target / kGroupWidth == i / kGroupWidth) {
+                ctrl_[i] = h2(h);
+                continue;
+            }
+            if (ctrl_[target] == kEmpty) {
+                new (&slots_[target]) Entry{std::move(slots_[i].key), std::move(slots_[i].value)};
+                slots_[i].~Entry();
+                ctrl_[target] = h2(h);
+                ctrl_[i] = kEmpty;
+                if (refBits_ != nullptr) {
+                    refBits_[target] = refBits_[i];
+                    refBits_[i] = 0;
+                }
+            } else {
+                std::swap(slots_[i], slots_[target]);
+                ctrl_[target] = h2(h);
+                if (refBits_ != nullptr) {
+                    std::swap(refBits_[i], refBits_[target]);
+                }
+                --i;  // на месте i теперь другой ждущий элемент
+            }
+        }
+        deleted_ = 0;
+
+        HASHMAP_STATS_ONLY(
+            ++counters_.rehashCount;
+            counters_.rehashTimeNs += elapsedNs(rehashStart);
+        )
+    }
+
+    // Если таблица уже достигла потолка ограниченного режима — чистим
+    // надгробия на месте (память не превышает потолка ни на миг). Если
+    // она забита в основном надгробиями — перестраиваем в той же ёмкости,
+    // иначе удваиваем ёмкость
+    void rehashForInsert() {
+        finishMigration();
 
-            if (!entry.occupied) {
-                throw std::out_of_range("Key not found");
+        bool atLimit = maxEntries_ > 0 && capacity_ >= boundedCapacity(maxEntries_);
+        size_t newCapacity = capacity_;
+        if (!atLimit && size_ >= maxLoad(capacity_) / 2) {
+            newCapacity = capacity_ * 2;
+        }
+
+        // На потолке — всегда на месте, и в инкрементальном режиме тоже:
+        // миграция в таблицу той же ёмкости держала бы две таблицы
+        // (вдвое больше потолка) на протяжении многих операций
+        if (atLimit) {
+            dropTombstones();
+        } else if (incremental_) {
+            startMigration(newCapacity);
+        } else {
+            rehash(newCapacity);
+        }
+    }
+
+    // Общая часть try_emplace/insert_or_assign: один проход по цепочке,
+    // значение конструируется только если ключа ещё нет.
+    // Возвращает индекс слота и признак того, что ключ был вставлен.
+    template<typename KK, typename... Args>
+    std::pair<size_t, bool> emplaceUnique(KK&& key, Args&&... args) {
+        migrateStep();
+
+        uint64_t h = hashOf(key);
+        bool found;
+        size_t index = findOrPrepareInsert(key, h, found);
+
+        if (found) {
+            touch(index);
+            return {index, false};
+        }
+
+        // Ключ ещё не перенесён из старой таблицы — переносим его сейчас
+        if (oldCtrl_ != nullptr) {
+            size_t oldIndex = findIndexIn(oldCtrl_, oldSlots_, oldCapacity_, key, h);
+            if (oldIndex != NOT_FOUND) {
+                return {moveFromOld(oldIndex, h), false};
             }
+        }
+
+        // Ограниченный режим: вместо роста освобождаем место вытеснением.
+        // Стрелка CLOCK ходит только по текущей таблице, поэтому перенос
+        // к этому моменту нужно закончить
+        if (maxEntries_ > 0 && size_ >= maxEntries_) {
+            finishMigration();
+            evictOne();
+            index = findInsertIndex(h);
+        }
+
+        if (size_ - oldSize_ + deleted_ >= maxLoad(capacity_)) {
+            rehashForInsert();
+            index = findInsertIndex(h);
+        }
+
+        if (ctrl_[index] == hashmap_detail::kDeleted) {
+            --deleted_;
+        }
+        new (&slots_[index]) Entry{K(std::forward<KK>(key)),
+                                   V(std::forward<Args>(args)...)};
+        ctrl_[index] = h2(h);
+        touch(index);
+        ++size_;
+        return {index, true};
+    }
 
-            if (entry.occupied && !entry.deleted && entry.key == key) {
-                return entry.value;
+    // Прямой обход занятых слотов: сначала текущая таблица, затем
+    // (во время миграции) ещё не перенесённая часть старой
+    template<typename EntryT, typename MapT>
+    class IteratorBase {
+    private:
+        MapT* map_;
+        size_t index_;
+
+        bool isFree() const {
+            if (index_ < map_->capacity_) {
+                return map_->ctrl_[index_] < 0;
+            }
+            return map_->oldCtrl_[index_ - map_->capacity_] < 0;
+        }
+
+        void skipFree() {
+            size_t end = map_->capacity_ + map_->oldCapacity_;
+            while (index_ < end && isFree()) {
+                ++index_;
+            }
+        }
+
+    public:
+        IteratorBase(MapT* map, size_t index) : map_(map), index_(index) {
+            skipFree();
+        }
+
+        EntryT& operator*() const { return *operator->(); }
+        EntryT* operator->() const {
+            if (index_ < map_->capacity_) {
+                return &map_->slots_[index_];
             }
+            return &map_->oldSlots_[index_ - map_->capacity_];
         }
-        throw std::out_of_range("Key not found");
+
+        IteratorBase& operator++() {
+            ++index_;
+            skipFree();
+            return *this;
+        }
+
+        bool operator==(const IteratorBase& other) const {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(const IteratorBase& other) const {
+            return index_ != other.index_;
+        }
+    };
+
+public:
+    HashMap() : HashMap(*std::pmr::get_default_resource()) {}
+
+    // Таблица, вся память которой берётся из resource (например, арены)
+    explicit HashMap(std::pmr::memory_resource& resource)
+        : ctrl_(nullptr), slots_(nullptr), size_(0), deleted_(0), capacity_(0),
+          resource_(&resource),
+          maxEntries_(0), refBits_(nullptr), hand_(0), evictions_(0),
+          incremental_(false), oldCtrl_(nullptr), oldSlots_(nullptr),
+          oldCapacity_(0), oldSize_(0), migrateCursor_(0),
+          rehashHook_{nullptr, nullptr} {
+        allocate(INITIAL_CAPACITY);
     }
 
-    const V& get(const K& key) const {
-        return const_cast<HashMap*>(this)->get(key);
+    ~HashMap() {
+        destroySlots();
+        deallocate();
     }
 
-    void remove(const K& key) {
-        size_t index = hash(key);
-        for (size_t i = 0; i < capacity_; ++i) {
-            size_t pos = probe(index, i);
-            Entry& entry = table_[pos];
+    // Копия живёт в куче по умолчанию, а не в арене оригинала
+    HashMap(const HashMap& other)
+        : HashMap(other, *std::pmr::get_default_resource()) {}
 
-            if (!entry.occupied) {
-                return;
+    // Копия всегда собирается в одну таблицу, даже если оригинал
+    // находится посреди инкрементального рехеша
+    HashMap(const HashMap& other, std::pmr::memory_resource& resource)
+        : ctrl_(nullptr), slots_(nullptr), size_(other.size_),
+          deleted_(other.deleted_), capacity_(0), hasher_(other.hasher_),
+          resource_(&resource),
+          maxEntries_(other.maxEntries_), refBits_(nullptr),
+          hand_(other.hand_), evictions_(other.evictions_),
+          incremental_(other.incremental_), oldCtrl_(nullptr), oldSlots_(nullptr),
+          oldCapacity_(0), oldSize_(0), migrateCursor_(0),
+          rehashHook_(other.rehashHook_) {
+        allocate(other.capacity_);
+
+        if (other.oldCtrl_ != nullptr) {
+            deleted_ = 0;
+            if (other.refBits_ != nullptr) {
+                refBits_ = allocateRefBits(capacity_);
+            }
+            for (const Entry& entry : other) {
+                Entry copy(entry);
+                placeEntry(std::move(copy), hashOf(entry.key));
             }
+            return;
+        }
 
-            if (entry.occupied && !entry.deleted && entry.key == key) {
-                entry.deleted = true;
-                --size_;
-                return;
+        std::memcpy(ctrl_, other.ctrl_, capacity_);
+        if (other.refBits_ != nullptr) {
+            refBits_ = allocateRefBits(capacity_);
+            std::memcpy(refBits_, other.refBits_, capacity_);
+        }
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] >= 0) {
+                new (&slots_[i]) Entry(other.slots_[i]);
+            }
+        }
+    }
+
+    // Перемещённый объект остаётся пустой, но рабочей таблицей
+    HashMap(HashMap&& other)
+        : ctrl_(other.ctrl_), slots_(other.slots_), size_(other.size_),
+          deleted_(other.deleted_), capacity_(other.capacity_),
+          hasher_(std::move(other.hasher_)), resource_(other.resource_),
+          maxEntries_(other.maxEntries_), refBits_(other.refBits_),
+          hand_(other.hand_), evictions_(other.evictions_),
+          incremental_(other.incremental_), oldCtrl_(other.oldCtrl_),
+          oldSlots_(other.oldSlots_), oldCapacity_(other.oldCapacity_),
+          oldSize_(other.oldSize_), migrateCursor_(other.migrateCursor_),
+          rehashHook_(other.rehashHook_) {
+        other.refBits_ = nullptr;
+        other.oldCtrl_ = nullptr;
+        other.oldSlots_ = nullptr;
+        other.releaseOldTable();
+        other.allocate(INITIAL_CAPACITY);
+        other.size_ = 0;
+        other.deleted_ = 0;
+        other.maxEntries_ = 0;
+        other.hand_ = 0;
+        other.evictions_ = 0;
+    }
+
+    // Присваивание копированием сохраняет прежний источник памяти
+    HashMap& operator=(const HashMap& other) {
+        if (this != &other) {
+            HashMap copy(other, *resource_);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    HashMap& operator=(HashMap&& other) noexcept {
+        if (this != &other) {
+            swap(other);
+        }
+        return *this;
+    }
+
+    void swap(HashMap& other) noexcept {
+        std::swap(ctrl_, other.ctrl_);
+        std::swap(slots_, other.slots_);
+        std::swap(size_, other.size_);
+        std::swap(deleted_, other.deleted_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(hasher_, other.hasher_);
+        std::swap(resource_, other.resource_);
+        std::swap(maxEntries_, other.maxEntries_);
+        std::swap(refBits_, other.refBits_);
+        std::swap(hand_, other.hand_);
+        std::swap(evictions_, other.evictions_);
+        std::swap(incremental_, other.incremental_);
+        std::swap(oldCtrl_, other.oldCtrl_);
+        std::swap(oldSlots_, other.oldSlots_);
+        std::swap(oldCapacity_, other.oldCapacity_);
+        std::swap(oldSize_, other.oldSize_);
+        std::swap(migrateCursor_, other.migrateCursor_);
+        std::swap(rehashHook_, other.rehashHook_);
+        HASHMAP_STATS_ONLY(std::swap(counters_, other.counters_);)
+    }
+
+    using iterator = IteratorBase<Entry, HashMap>;
+    using const_iterator = IteratorBase<const Entry, const HashMap>;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, capacity_ + oldCapacity_); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, capacity_ + oldCapacity_); }
+
+    void insert(const K& key, const V& value) {
+        insert_or_assign(key, value);
+    }
+
+    // Вставляет значение, построенное из args, только если ключа ещё нет.
+    // Возвращает указатель на значение в таблице и признак вставки.
+    template<typename... Args>
+    std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+        auto result = emplaceUnique(key, std::forward<Args>(args)...);
+        return {&slots_[result.first].value, result.second};
+    }
+
+    template<typename... Args>
+    std::pair<V*, bool> try_emplace(K&& key, Args&&... args) {
+        auto result = emplaceUnique(std::move(key), std::forward<Args>(args)...);
+        return {&slots_[result.first].value, result.second};
+    }
+
+    template<typename M>
+    std::pair<V*, bool> insert_or_assign(const K& key, M&& value) {
+        auto result = emplaceUnique(key, std::forward<M>(value));
+        if (!result.second) {
+            slots_[result.first].value = std::forward<M>(value);
+        }
+        return {&slots_[result.first].value, result.second};
+    }
+
+    template<typename M>
+    std::pair<V*, bool> insert_or_assign(K&& key, M&& value) {
+        auto result = emplaceUnique(std::move(key), std::forward<M>(value));
+        if (!result.second) {
+            slots_[result.first].value = std::forward<M>(value);
+        }
+        return {&slots_[result.first].value, result.second};
+    }
+
+    // Поиск за один проход: указатель на значение или nullptr
+    V* find(const K& key) {
+        migrateStep();
+        Entry* entry = lookup(key);
+        return entry != nullptr ? &entry->value : nullptr;
+    }
+
+    const V* find(const K& key) const {
+        const Entry* entry = lookup(key);
+        return entry != nullptr ? &entry->value : nullptr;
+    }
+
+    bool contains(const K& key) const {
+        return lookup(key) != nullptr;
+    }
+
+    V& get(const K& key) {
+        V* value = find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("Key not found");
+        }
+        return *value;
+    }
+
+    const V& get(const K& key) const {
+        const V* value = find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("Key not found");
+        }
+        return *value;
+    }
+
+    void remove(const K& key) {
+        migrateStep();
+        uint64_t h = hashOf(key);
+        size_t index = findIndex(key, h);
+        if (index != NOT_FOUND) {
+            eraseAt(index);
+            return;
+        }
+        if (oldCtrl_ != nullptr) {
+            index = findIndexIn(oldCtrl_, oldSlots_, oldCapacity_, key, h);
+            if (index != NOT_FOUND) {
+                eraseOldAt(index);
             }
         }
     }
 
     size_t size() const { return size_; }
     bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+    std::pmr::memory_resource* resource() const { return resource_; }
+
+    // Заранее готовит таблицу под n элементов без промежуточных рехешей.
+    // В ограниченном режиме ёмкость фиксирована и reserve ничего не делает.
+    void reserve(size_t n) {
+        if (maxEntries_ > 0) {
+            return;
+        }
+        finishMigration();
+        size_t newCapacity = capacity_;
+        while (maxLoad(newCapacity) <= n) {
+            newCapacity *= 2;
+        }
+        if (newCapacity != capacity_) {
+            rehash(newCapacity);
+        }
+    }
 
     void clear() {
-        for (size_t i = 0; i < capacity_; ++i) {
-            table_[i] = Entry();
+        destroySlots();
+        releaseOldTable();
+        std::memset(ctrl_, hashmap_detail::kEmpty, capacity_);
+        if (refBits_ != nullptr) {
+            std::memset(refBits_, 0, capacity_);
         }
         size_ = 0;
+        deleted_ = 0;
+    }
+
+    // Включает ограниченный режим: не больше maxEntries элементов,
+    // сверх лимита — вытеснение CLOCK. 0 — снова неограниченный рост.
+    void setMaxEntries(size_t maxEntries) {
+        finishMigration();
+        maxEntries_ = maxEntries;
+        if (maxEntries_ == 0) {
+            freeRefBits(refBits_, capacity_);
+            refBits_ = nullptr;
+            return;
+        }
+
+        if (refBits_ == nullptr) {
+            refBits_ = allocateRefBits(capacity_);
+        }
+        while (size_ > maxEntries_) {
+            evictOne();
+        }
+        // Таблица растёт как обычно, пока не упрётся в предельную ёмкость
+        if (capacity_ > boundedCapacity(maxEntries_)) {
+            rehash(boundedCapacity(maxEntries_));
+        }
+    }
+
+    // То же, но лимит задаётся бюджетом памяти в байтах (слоты +
+    // управляющие байты + биты обращения). В бюджет входит и пик
+    // последнего роста, когда рядом с таблицей предельной ёмкости ещё
+    // живёт прежняя, вдвое меньшая; после него таблица больше не
+    // перевыделяется. false — бюджет меньше самой маленькой таблицы
+    // (INITIAL_CAPACITY слотов), лимит не меняется.
+    bool setMemoryBudget(size_t bytes) {
+        const size_t bytesPerSlot = sizeof(Entry) + 2;
+        auto peak = [bytesPerSlot](size_t capacity) {
+            return (capacity + capacity / 2) * bytesPerSlot;
+        };
+        if (peak(INITIAL_CAPACITY) > bytes) {
+            return false;
+        }
+        size_t capacity = INITIAL_CAPACITY;
+        while (peak(capacity * 2) <= bytes) {
+            capacity *= 2;
+        }
+        setMaxEntries(maxLoad(capacity) / 2);
+        return true;
+    }
+
+    size_t maxEntries() const { return maxEntries_; }
+    size_t evictions() const { return evictions_; }
+
+    // Инкрементальный рехеш: вместо одного долгого перестроения таблицы
+    // каждая вставка/поиск/удаление переносит по несколько групп
+    void setIncrementalRehash(bool enabled) {
+        incremental_ = enabled;
+        if (!enabled) {
+            finishMigration();
+        }
+    }
+
+    bool isRehashing() const { return oldCtrl_ != nullptr; }
+
+    void setRehashHook(const RehashHook& hook) {
+        rehashHook_ = hook;
+    }
+
+    // Текущее состояние таблицы и накопленные (с HASHMAP_STATS) счётчики
+    HashMapStats stats() const {
+        HashMapStats result;
+    #ifdef HASHMAP_STATS
+        result = counters_;
+        result.detailed = true;
+    #endif
+        result.size = size_;
+        result.capacity = capacity_;
+        result.tombstones = deleted_;
+        result.loadFactor = static_cast<double>(size_ - oldSize_) / static_cast<double>(capacity_);
+        result.effectiveLoadFactor =
+            static_cast<double>(size_ - oldSize_ + deleted_) / static_cast<double>(capacity_);
+
+        const size_t bytesPerSlot = sizeof(Entry) + 1 + (refBits_ != nullptr ? 1 : 0);
+        result.bytesAllocated = capacity_ * bytesPerSlot + oldCapacity_ * (sizeof(Entry) + 1);
+        return result;
+    }
+
+    // Обнуляет гистограммы и счётчики рехешей (например, перед каждым поиском)
+    void resetStats() {
+        HASHMAP_STATS_ONLY(counters_.resetCounters();)
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,178 @@
+// Match.hpp
+#pragma once
+#include "Board.hpp"
+#include "GameRecord.hpp"
+#include "MinimaxAI.hpp"
+#include "Telemetry.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+
+// Партия между двумя движками без всякого ввода-вывода: для пакетных
+// прогонов (headless-режим main, турниры). Результат зависит только
+// от настроек и seed — одинаковый seed даёт одинаковую партию.
+
+enum class EngineKind {
+    Minimax,        // минимакс с транспозиционной таблицей
+    MinimaxNoMemo,  // минимакс без мемоизации
+    Pattern,        // минимакс с таблицей и оценкой образцами
+    Random          // случайный ход
+};
+
+struct EngineSpec {
+    EngineKind kind;
+    int depth;
+
+    EngineSpec() : kind(EngineKind::Minimax), depth(9) {}
+    EngineSpec(EngineKind k, int d) : kind(k), depth(d) {}
+
+    // "minimax", "minimax:6", "nomemo:4", "pattern:3", "random";
+    // без глубины — defaultDepth
+    static bool parse(const std::string& text, int defaultDepth, EngineSpec& out) {
+        std::string name = text;
+        int depth = defaultDepth;
+        size_t colon = text.find(':');
+        if (colon != std::string::npos) {
+            name = text.substr(0, colon);
+            depth = std::atoi(text.c_str() + colon + 1);
+            if (depth < 1) {
+                return false;
+            }
+        }
+
+        if (name == "minimax") {
+            out = EngineSpec(EngineKind::Minimax, depth);
+        } else if (name == "nomemo") {
+            out = EngineSpec(EngineKind::MinimaxNoMemo, depth);
+        } else if (name == "pattern") {
+            out = EngineSpec(EngineKind::Pattern, depth);
+        } else if (name == "random") {
+            out = EngineSpec(EngineKind::Random, 0);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    std::string name() const {
+        switch (kind) {
+            case EngineKind::Minimax: return "minimax:" + std::to_string(depth);
+            case EngineKind::MinimaxNoMemo: return "nomemo:" + std::to_string(depth);
+            case EngineKind::Pattern: return "pattern:" + std::to_string(depth);
+            case EngineKind::Random: return "random";
+        }
+        return "?";
+    }
+};
+
+struct MatchConfig {
+    int size;
+    int winLength;
+    EngineSpec x;
+    EngineSpec o;
+    int randomOpeningMoves;  // первые ходы партии — случайные, для разнообразия
+    size_t cacheLimit;       // потолок транспозиционной таблицы (0 — без него)
+
+    MatchConfig()
+        : size(3), winLength(3), randomOpeningMoves(2), cacheLimit(1 << 19) {}
+};
+
+struct GameResult {
+    uint64_t seed;
+    CellState winner;        // Empty — ничья
+    int moves;
+    long long timeUsX;       // суммарное время поиска каждой стороны
+    long long timeUsO;
+    size_t nodesX;
+    size_t nodesO;
+    std::string moveList;    // "r,c r,c ..." в порядке ходов
+    records::GameRecord record;  // ходы и оценки для двоичного архива
+
+    GameResult()
+        : seed(0), winner(CellState::Empty), moves(0), timeUsX(0), timeUsO(0),
+          nodesX(0), nodesO(0) {}
+
+    const char* winnerName() const {
+        return winner == CellState::X ? "X" : winner == CellState::O ? "O" : "draw";
+    }
+};
+
+// telemetry — необязательный журнал ходов ИИ (gameId = seed)
+inline GameResult playGame(const MatchConfig& config, uint64_t seed,
+                           telemetry::Sink* telemetry = nullptr) {
+    Board board(config.size, config.winLength);
+    std::mt19937_64 rng(seed);
+
+    std::unique_ptr<MinimaxAI> engines[2];
+    const EngineSpec* specs[2] = {&config.x, &config.o};
+    for (int side = 0; side < 2; ++side) {
+        if (specs[side]->kind != EngineKind::Random) {
+            engines[side].reset(new MinimaxAI(side == 0 ? Player::X : Player::O,
+                                              specs[side]->depth,
+                                              specs[side]->kind != EngineKind::MinimaxNoMemo));
+            engines[side]->setCacheLimit(config.cacheLimit);
+            if (specs[side]->kind == EngineKind::Pattern) {
+                engines[side]->setEvaluator(Evaluator::Pattern);
+            }
+            // Оценку на большом поле по-прежнему задаёт вид движка —
+            // так турнир сравнивает эвристики и там
+            if (config.size >= LARGE_BOARD_MIN_SIZE) {
+                engines[side]->setMoveRadius(LARGE_BOARD_MOVE_RADIUS);
+            }
+        }
+    }
+
+    GameResult result;
+    result.seed = seed;
+    result.record = records::GameRecord(config.size, config.winLength);
+    size_t aiMoves[2] = {0, 0};
+
+    for (int side = 0; ; side = 1 - side) {
+        CellState cell = side == 0 ? CellState::X : CellState::O;
+        MoveList empty = board.getEmptyCells();
+
+        Coord move;
+        int score = 0;
+        if (result.moves < config.randomOpeningMoves || !engines[side]) {
+            std::uniform_int_distribution<size_t> pick(0, empty.size() - 1);
+            move = empty[pick(rng)];
+        } else {
+            auto start = std::chrono::steady_clock::now();
+            MoveEvaluation eval = engines[side]->findBestMove(board);
+            auto end = std::chrono::steady_clock::now();
+            move = eval.move;
+            score = eval.score;
+
+            long long us = std::chrono::duration_cast<std::chrono::microseconds>(
+                end - start).count();
+            const AIStatistics& stats = engines[side]->getStatistics();
+            (side == 0 ? result.timeUsX : result.timeUsO) += us;
+            (side == 0 ? result.nodesX : result.nodesO) += stats.nodesVisited;
+            if (telemetry != nullptr) {
+                telemetry->record(static_cast<long long>(seed), ++aiMoves[side],
+                                  static_cast<char>(cell), move, eval.score, stats);
+            }
+        }
+
+        board.set(move, cell);
+        result.record.addMove(move, score);
+        ++result.moves;
+        if (!result.moveList.empty()) {
+            result.moveList += ' ';
+        }
+        result.moveList += std::to_string(move.row) + "," + std::to_string(move.col);
+
+        if (board.checkWin(cell)) {
+            result.winner = cell;
+            result.record.result = side == 0 ? records::Result::XWins : records::Result::OWins;
+            return result;
+        }
+        if (board.isFull()) {
+            result.record.result = records::Result::Draw;
+            return result;
+        }
+    }
+}
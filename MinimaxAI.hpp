@@ -1,11 +1,21 @@
 // MinimaxAI.hpp
 #pragma once
+#include "Arena.hpp"
 #include "Board.hpp"
 #include "HashMap.hpp"
+#include "PatternEval.hpp"
 #include "DynamicArray.hpp"
+#include "PerfCounters.hpp"
+#include "Tracer.hpp"
+#include <atomic>
 #include <limits>
+#include <optional>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <vector>
 
 enum class Player {
     X,
@@ -20,26 +30,206 @@ struct MoveEvaluation {
     MoveEvaluation(const Coord& m, int s) : move(m), score(s) {}
 };
 
+// Эвристика в листьях поиска
+enum class Evaluator {
+    Center,     // фишки ближе к центру ценнее
+    Pattern     // образцы в окнах линий (PatternEval.hpp)
+};
+
+// Поля больше 10x10 (гомоку 15x15 и 19x19) играются в режиме большой
+// доски: перебирать там все пустые клетки безнадёжно, ходы ищутся
+// только рядом с фишками
+const int LARGE_BOARD_MIN_SIZE = 11;
+const int LARGE_BOARD_MOVE_RADIUS = 1;
+
+// Запись транспозиционной таблицы. Оценка, полученная с отсечением,
+// — лишь граница настоящей, а оценка с меньшей остаточной глубиной
+// годится не для любого поиска: без этих полей таблица, пережившая
+// поиск (и тем более партию), отдавала бы неверные оценки. Выигрыш
+// и проигрыш хранятся относительно самого узла (см. MinimaxAI::toTable).
+struct TTEntry {
+    enum Bound : int8_t {
+        Exact,
+        Lower,   // настоящая оценка >= score (было отсечение по beta)
+        Upper    // настоящая оценка <= score (ни один ход не поднял alpha)
+    };
+
+    int score;
+    int16_t depth;   // остаточная глубина, на которой получена оценка
+    Bound bound;
+    bool win;        // score — выигрыш или проигрыш: ±(WIN_SCORE - ходов до победы)
+
+    TTEntry() : score(0), depth(0), bound(Exact), win(false) {}
+    TTEntry(int s, int d, Bound b, bool w = false)
+        : score(s), depth(static_cast<int16_t>(d)), bound(b), win(w) {}
+};
+
+// Профилирование поиска по фазам включается на этапе компиляции
+// (-DAI_PROFILE); без него замеры и счётчики не компилируются,
+// а поля SearchProfile остаются нулевыми.
+#ifdef AI_PROFILE
+#define AI_PROFILE_ONLY(...) __VA_ARGS__
+#else
+#define AI_PROFILE_ONLY(...)
+#endif
+
+// Где тратится время поиска. Время фаз включающее: evaluate
+// содержит и собственные вызовы checkWin.
+struct SearchProfile {
+    enum Phase {
+        CheckWin,
+        Evaluate,
+        MoveGen,
+        TTProbe,
+        TTStore,
+        Hash,
+        PHASE_COUNT
+    };
+
+    static constexpr int MAX_PLY = 64;
+
+    bool enabled;
+    uint64_t phaseNs[PHASE_COUNT];
+    uint64_t phaseCalls[PHASE_COUNT];
+    uint64_t nodesAtPly[MAX_PLY];   // ply 0 — корень
+    uint64_t expandedNodes;         // узлы, в которых перебирались ходы
+    uint64_t betaCutoffs;
+    uint64_t cutoffIndexSum;        // номер хода (с 1), давшего отсечение
+
+    SearchProfile()
+        : enabled(false), phaseNs(), phaseCalls(), nodesAtPly(),
+          expandedNodes(0), betaCutoffs(0), cutoffIndexSum(0) {}
+
+    static const char* phaseName(int phase) {
+        static const char* const names[PHASE_COUNT] = {
+            "checkWin", "evaluate", "moveGen", "ttProbe", "ttStore", "hash"
+        };
+        return names[phase];
+    }
+
+    void recordNode(int ply) {
+        ++nodesAtPly[ply < MAX_PLY ? ply : MAX_PLY - 1];
+    }
+
+    void recordCutoff(size_t moveIndex) {
+        ++betaCutoffs;
+        cutoffIndexSum += moveIndex + 1;
+    }
+
+    int deepestPly() const {
+        int last = 0;
+        for (int ply = 0; ply < MAX_PLY; ++ply) {
+            if (nodesAtPly[ply] > 0) {
+                last = ply;
+            }
+        }
+        return last;
+    }
+
+    // Эффективный коэффициент ветвления: (N_last / N_0)^(1 / last)
+    double effectiveBranchingFactor() const {
+        int last = deepestPly();
+        if (last == 0 || nodesAtPly[0] == 0) {
+            return 0.0;
+        }
+        return std::pow(static_cast<double>(nodesAtPly[last])
+                        / static_cast<double>(nodesAtPly[0]), 1.0 / last);
+    }
+
+    double cutoffRate() const {
+        return expandedNodes > 0
+            ? static_cast<double>(betaCutoffs) / static_cast<double>(expandedNodes)
+            : 0.0;
+    }
+
+    double averageCutoffIndex() const {
+        return betaCutoffs > 0
+            ? static_cast<double>(cutoffIndexSum) / static_cast<double>(betaCutoffs)
+            : 0.0;
+    }
+
+    // Узлы по глубинам через ';' — одно поле CSV
+    std::string nodesPerPly() const {
+        std::string result;
+        int last = deepestPly();
+        for (int ply = 0; ply <= last; ++ply) {
+            if (ply > 0) {
+                result += ';';
+            }
+            result += std::to_string(nodesAtPly[ply]);
+        }
+        return result;
+    }
+};
+
+// Замер одной фазы на время жизни объекта
+class ScopedPhaseTimer {
+private:
+    SearchProfile& profile_;
+    SearchProfile::Phase phase_;
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    ScopedPhaseTimer(SearchProfile& profile, SearchProfile::Phase phase)
+        : profile_(profile), phase_(phase), start_(std::chrono::steady_clock::now()) {}
+
+    ~ScopedPhaseTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        profile_.phaseNs[phase_] += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        ++profile_.phaseCalls[phase_];
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+};
+
+#define AI_PROFILE_SCOPE(profile, phase) \
+    AI_PROFILE_ONLY(ScopedPhaseTimer profileTimer_##phase((profile), SearchProfile::phase);)
+
 struct AIStatistics {
     size_t nodesVisited;
     size_t nodesGenerated;
     size_t cacheHits;
     size_t cacheMisses;
+    size_t cacheEvictions;
     long long timeMs;
+    int depthReached;       // глубина последней завершённой итерации
+    bool stopped;           // поиск прерван по времени или stop()
+
+    // Состояние транспозиционной таблицы после поиска
+    // (гистограммы пробирования — при сборке с -DHASHMAP_STATS)
+    HashMapStats cache;
+
+    // Фазы поиска, узлы по глубинам и отсечения (только с -DAI_PROFILE)
+    SearchProfile profile;
+
+    // Аппаратные счётчики за поиск (если включены и доступны)
+    HardwareCounters hardware;
 
     AIStatistics()
         : nodesVisited(0),
           nodesGenerated(0),
           cacheHits(0),
           cacheMisses(0),
-          timeMs(0) {}
+          cacheEvictions(0),
+          timeMs(0),
+          depthReached(0),
+          stopped(false) {}
 
     void reset() {
         nodesVisited = 0;
         nodesGenerated = 0;
         cacheHits = 0;
         cacheMisses = 0;
+        cacheEvictions = 0;
         timeMs = 0;
+        depthReached = 0;
+        stopped = false;
+        cache = HashMapStats();
+        profile = SearchProfile();
+        hardware = HardwareCounters();
+        AI_PROFILE_ONLY(profile.enabled = true;)
     }
 
     void print() const {
@@ -48,6 +238,9 @@ struct AIStatistics {
         std::cout << "  Сгенерировано узлов: " << nodesGenerated << "\n";
         std::cout << "  Попаданий в кеш: " << cacheHits << "\n";
         std::cout << "  Промахов мимо кеша: " << cacheMisses << "\n";
+        if (cacheEvictions > 0) {
+            std::cout << "  Вытеснено из кеша: " << cacheEvictions << "\n";
+        }
         std::cout << "  Время работы: " << timeMs << " мс\n";
         if (cacheHits + cacheMisses > 0) {
             double hitRate =
@@ -55,6 +248,78 @@ struct AIStatistics {
                 / static_cast<double>(cacheHits + cacheMisses);
             std::cout << "  Доля попаданий в кеш: " << hitRate << "%\n";
         }
+        if (cache.capacity > 0) {
+            printCacheStats();
+        }
+        if (profile.enabled) {
+            printProfile();
+        }
+        if (hardware.available()) {
+            printHardware();
+        }
+    }
+
+    void printHardware() const {
+        std::cout << "  Аппаратные счётчики:\n";
+        if (hardware.has(HardwareCounters::Cycles)) {
+            std::cout << "    Тактов: " << hardware.get(HardwareCounters::Cycles)
+                      << ", инструкций: " << hardware.get(HardwareCounters::Instructions)
+                      << ", IPC: " << hardware.ipc() << "\n";
+        }
+        if (hardware.has(HardwareCounters::BranchMisses)) {
+            std::cout << "    Промахов предсказания ветвлений: "
+                      << 100.0 * hardware.branchMissRate() << "%\n";
+        }
+        if (hardware.has(HardwareCounters::L1DMisses)) {
+            std::cout << "    Промахов L1D: " << 100.0 * hardware.l1dMissRate() << "%\n";
+        }
+        if (hardware.has(HardwareCounters::LLCMisses)) {
+            std::cout << "    Промахов LLC: " << 100.0 * hardware.llcMissRate() << "%\n";
+        }
+    }
+
+    void printProfile() const {
+        std::cout << "  Профиль поиска (время включающее):\n";
+        for (int phase = 0; phase < SearchProfile::PHASE_COUNT; ++phase) {
+            uint64_t calls = profile.phaseCalls[phase];
+            std::cout << "    " << SearchProfile::phaseName(phase) << ": "
+                      << profile.phaseNs[phase] / 1000 << " мкс, вызовов " << calls;
+            if (calls > 0) {
+                std::cout << " (" << profile.phaseNs[phase] / calls << " нс/вызов)";
+            }
+            std::cout << "\n";
+        }
+        std::cout << "    Узлов по глубинам: " << profile.nodesPerPly() << "\n";
+        std::cout << "    Эффективный коэффициент ветвления: "
+                  << profile.effectiveBranchingFactor() << "\n";
+        std::cout << "    Доля бета-отсечений: " << 100.0 * profile.cutoffRate()
+                  << "%, средний номер хода отсечения: "
+                  << profile.averageCutoffIndex() << "\n";
+    }
+
+    void printCacheStats() const {
+        std::cout << "  Транспозиционная таблица:\n";
+        std::cout << "    Элементов / ёмкость: " << cache.size
+                  << " / " << cache.capacity << "\n";
+        std::cout << "    Надгробий: " << cache.tombstones << "\n";
+        std::cout << "    Загрузка (с надгробиями): " << cache.loadFactor
+                  << " (" << cache.effectiveLoadFactor << ")\n";
+        std::cout << "    Памяти выделено: " << cache.bytesAllocated / 1024 << " КБ\n";
+        if (!cache.detailed) {
+            return;
+        }
+        std::cout << "    Рехешей: " << cache.rehashCount << " ("
+                  << cache.rehashTimeNs / 1000 << " мкс)\n";
+        std::cout << "    Средняя длина пробирования (попадание / промах): "
+                  << cache.averageHitProbe() << " / "
+                  << cache.averageMissProbe() << " групп\n";
+        std::cout << "    Гистограмма (групп: попаданий/промахов):";
+        for (size_t i = 0; i < HashMapStats::PROBE_BUCKETS; ++i) {
+            std::cout << " " << (i + 1)
+                      << (i + 1 == HashMapStats::PROBE_BUCKETS ? "+" : "")
+                      << ":" << cache.hitProbes[i] << "/" << cache.missProbes[i];
+        }
+        std::cout << "\n";
     }
 };
 
@@ -63,13 +328,75 @@ private:
     Player player_;
     Player opponent_;
     int maxDepth_;
+    int searchDepth_;       // глубина текущего прохода от корня
+    bool iterative_;        // итеративное углубление (findBestMoveTimed)
     bool useMemoization_;
 
+    // Оценка образцами ведётся приращениями: patternScore_ — сумма окон
+    // текущей позиции поиска со стороны X, её правит каждый place()
+    Evaluator evaluator_;
+    PatternEvaluator patterns_;
+    bool patternActive_;    // Pattern выбран и длина линии поддержана
+    int patternScore_;
+
+    // Ходы только рядом с фишками (Чебышёв <= moveRadius_; 0 — все
+    // пустые клетки). Фишки позиции поиска — разреженным списком-стеком,
+    // его ведёт place(); дубли соседей отсекаются метками с номером
+    // прохода, которые не надо чистить.
+    int moveRadius_;
+    std::vector<Coord> stones_;
+    std::vector<uint32_t> moveMark_;
+    uint32_t markEpoch_;
+
+    // Победа проверяется только по линиям последнего хода; если победа
+    // на поле была ещё до поиска, — по всему полю, как раньше
+    bool fullWinCheck_;
+
     // Транспозиционная таблица для мемоизации
-    HashMap<size_t, int> transpositionTable_;
+    HashMap<size_t, TTEntry> transpositionTable_;
+
+    // Режим "кеш на один поиск": таблица живёт в арене и выбрасывается
+    // вместе с ней в конце findBestMove, без единого delete
+    bool persistentCache_;
+    size_t cacheLimit_;
+    MonotonicArena searchArena_;
+
+    // Таблица текущего поиска (постоянная или из арены)
+    HashMap<size_t, TTEntry>* table_;
 
     AIStatistics stats_;
 
+    // Аппаратные счётчики вокруг findBestMove (выключены по умолчанию)
+    PerfCounters perf_;
+
+    // Прерывание поиска: stop() из другого потока или истёкший лимит
+    // времени. Прерванная итерация ничего не пишет в таблицу, а её
+    // результат отбрасывается.
+    std::atomic<bool> stopRequested_;
+    bool aborted_;
+    bool hasDeadline_;
+    std::chrono::steady_clock::time_point deadline_;
+
+    // Время проверяется раз в столько узлов, флаг stop — в каждом
+    static constexpr size_t DEADLINE_CHECK_NODES = 1024;
+
+    bool shouldAbort() {
+        if (aborted_) {
+            return true;
+        }
+        // Первая итерация углубления доигрывается всегда: так у прерванного
+        // поиска есть хотя бы ход с оценкой на глубину 1
+        if (iterative_ && stats_.depthReached == 0) {
+            return false;
+        }
+        if (stopRequested_.load(std::memory_order_relaxed)
+            || (hasDeadline_ && stats_.nodesVisited % DEADLINE_CHECK_NODES == 0
+                && std::chrono::steady_clock::now() >= deadline_)) {
+            aborted_ = true;
+        }
+        return aborted_;
+    }
+
     CellState playerToCell(Player p) const {
         return p == Player::X ? CellState::X : CellState::O;
     }
@@ -78,17 +405,63 @@ private:
         return p == Player::X ? Player::O : Player::X;
     }
 
-    // Эвристическая оценка позиции
+    // Ход или откат в поиске: с оценкой образцами сумма окон
+    // обновляется до изменения клетки
+    void place(Board& board, const Coord& move, CellState cell) {
+        if (patternActive_) {
+            AI_PROFILE_SCOPE(stats_.profile, Evaluate);
+            patternScore_ += patterns_.delta(board, move.row, move.col, cell);
+        }
+        if (moveRadius_ > 0) {
+            if (cell == CellState::Empty) {
+                stones_.pop_back();
+            } else {
+                stones_.push_back(move);
+            }
+        }
+        board.set(move, cell);
+    }
+
+    // Счёт выигрыша: WIN_SCORE плюс остаточная глубина победного узла,
+    // так что более быстрая победа дороже
+    static constexpr int WIN_SCORE = 1000;
+
+    // Оценка образцами не должна дотягивать до счёта выигрыша (±1000)
+    static constexpr int PATTERN_SCORE_LIMIT = 900;
+
+    // Счёт выигрыша зависит от глубины корня, а таблица переживает
+    // поиски с другой maxDepth. Поэтому в таблицу пишется число ходов до
+    // победы от самого узла, а при чтении оно снова переводится в счёт
+    // читающего узла. Победу дальше его горизонта таблица не отдаёт:
+    // с ней он выбрал бы её вместо более быстрой в пределах глубины.
+    static TTEntry toTable(int score, int depth, TTEntry::Bound bound) {
+        if (score >= WIN_SCORE) {
+            return TTEntry(score - depth, depth, bound, true);
+        }
+        if (score <= -WIN_SCORE) {
+            return TTEntry(score + depth, depth, bound, true);
+        }
+        return TTEntry(score, depth, bound);
+    }
+
+    static bool fromTable(const TTEntry& entry, int depth, int& score) {
+        if (!entry.win) {
+            score = entry.score;
+            return true;
+        }
+        score = entry.score > 0 ? entry.score + depth : entry.score - depth;
+        return std::abs(score) >= WIN_SCORE;
+    }
+
+    // Эвристическая оценка позиции. Победы сюда не доходят: их
+    // отсекает minimax до вызова оценки.
     int evaluate(const Board& board) const {
         CellState playerCell = playerToCell(player_);
         CellState opponentCell = playerToCell(opponent_);
 
-        // Проверка победы
-        if (board.checkWin(playerCell)) {
-            return 1000;
-        }
-        if (board.checkWin(opponentCell)) {
-            return -1000;
+        if (patternActive_) {
+            int score = player_ == Player::X ? patternScore_ : -patternScore_;
+            return std::max(-PATTERN_SCORE_LIMIT, std::min(PATTERN_SCORE_LIMIT, score));
         }
 
         int score = 0;
@@ -117,38 +490,125 @@ private:
         return score;
     }
 
+    MoveList generateMoves(const Board& board) {
+        AI_PROFILE_SCOPE(stats_.profile, MoveGen);
+        if (moveRadius_ <= 0 || stones_.empty()) {
+            return board.getEmptyCells();
+        }
+
+        if (++markEpoch_ == 0) {
+            std::fill(moveMark_.begin(), moveMark_.end(), 0);
+            markEpoch_ = 1;
+        }
+        int size = board.getSize();
+        MoveList moves;
+        // Сначала соседи последних ходов — там чаще всего и лучший ответ
+        for (size_t s = stones_.size(); s-- > 0;) {
+            const Coord& stone = stones_[s];
+            for (int row = std::max(0, stone.row - moveRadius_);
+                 row <= std::min(size - 1, stone.row + moveRadius_); ++row) {
+                for (int col = std::max(0, stone.col - moveRadius_);
+                     col <= std::min(size - 1, stone.col + moveRadius_); ++col) {
+                    uint32_t& mark = moveMark_[row * size + col];
+                    if (mark != markEpoch_ && board.isEmpty(row, col)) {
+                        mark = markEpoch_;
+                        moves.push_back(Coord(row, col));
+                    }
+                }
+            }
+        }
+        return moves;
+    }
+
+    // Список фишек и метки ходов под позицию, с которой начат поиск
+    void prepareMoveGeneration(const Board& board) {
+        stones_.clear();
+        if (moveRadius_ <= 0) {
+            return;
+        }
+        int size = board.getSize();
+        moveMark_.assign(static_cast<size_t>(size * size), 0);
+        markEpoch_ = 0;
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                if (!board.isEmpty(row, col)) {
+                    stones_.push_back(Coord(row, col));
+                }
+            }
+        }
+    }
+
     // Минимакс с альфа-бета отсечением
-    int minimax(Board& board, int depth, int alpha, int beta,
+    // lastMove — ход, которым пришли в эту позицию
+    int minimax(Board& board, const Coord& lastMove, int depth, int alpha, int beta,
                 Player currentPlayer, bool isMaximizing) {
 
         stats_.nodesVisited++;
+        AI_PROFILE_ONLY(stats_.profile.recordNode(searchDepth_ - depth);)
+        if (shouldAbort()) {
+            return 0;
+        }
 
         CellState playerCell = playerToCell(player_);
         CellState opponentCell = playerToCell(opponent_);
 
         // Проверка терминального состояния
-        if (board.checkWin(playerCell)) {
-            return 1000 + depth; // предпочитаем более быстрые победы
+        bool playerWon;
+        bool opponentWon = false;
+        {
+            AI_PROFILE_SCOPE(stats_.profile, CheckWin);
+            if (fullWinCheck_) {
+                playerWon = board.checkWin(playerCell);
+                if (!playerWon) {
+                    opponentWon = board.checkWin(opponentCell);
+                }
+            } else {
+                bool moverWon = board.checkWinAt(lastMove);
+                playerWon = moverWon && board.get(lastMove) == playerCell;
+                opponentWon = moverWon && !playerWon;
+            }
+        }
+        if (playerWon) {
+            return WIN_SCORE + depth; // предпочитаем более быстрые победы
         }
-        if (board.checkWin(opponentCell)) {
-            return -1000 - depth;
+        if (opponentWon) {
+            return -WIN_SCORE - depth;
         }
         if (board.isFull() || depth <= 0) {
+            AI_PROFILE_SCOPE(stats_.profile, Evaluate);
             return evaluate(board);
         }
 
         // Проверка кеша
+        size_t hash = 0;
         if (useMemoization_) {
-            size_t hash = board.hash();
-            if (transpositionTable_.contains(hash)) {
-                stats_.cacheHits++;
-                return transpositionTable_.get(hash);
+            {
+                AI_PROFILE_SCOPE(stats_.profile, Hash);
+                hash = board.hash();
+            }
+            const TTEntry* cached;
+            {
+                AI_PROFILE_SCOPE(stats_.profile, TTProbe);
+                cached = table_->find(hash);
+            }
+            int score;
+            if (cached != nullptr && cached->depth >= depth
+                && fromTable(*cached, depth, score)) {
+                if (cached->bound == TTEntry::Exact
+                    || (cached->bound == TTEntry::Lower && score >= beta)
+                    || (cached->bound == TTEntry::Upper && score <= alpha)) {
+                    stats_.cacheHits++;
+                    return score;
+                }
             }
             stats_.cacheMisses++;
         }
+        const int alphaOrig = alpha;
+        const int betaOrig = beta;
 
-        DynamicArray<Coord> moves = board.getEmptyCells();
+        MoveList moves = generateMoves(board);
         stats_.nodesGenerated += moves.size();
+        AI_PROFILE_ONLY(stats_.profile.expandedNodes++;)
 
         int bestScore;
         CellState currentCell = playerToCell(currentPlayer);
@@ -157,15 +617,16 @@ private:
             bestScore = std::numeric_limits<int>::min();
 
             for (size_t i = 0; i < moves.size(); ++i) {
-                board.set(moves[i], currentCell);
-                int score = minimax(board, depth - 1, alpha, beta,
+                place(board, moves[i], currentCell);
+                int score = minimax(board, moves[i], depth - 1, alpha, beta,
                                     getOpponent(currentPlayer), false);
-                board.set(moves[i], CellState::Empty);
+                place(board, moves[i], CellState::Empty);
 
                 bestScore = std::max(bestScore, score);
                 alpha = std::max(alpha, bestScore);
 
                 if (beta <= alpha) {
+                    AI_PROFILE_ONLY(stats_.profile.recordCutoff(i);)
                     break; // альфа-бета отсечение
                 }
             }
@@ -173,65 +634,59 @@ private:
             bestScore = std::numeric_limits<int>::max();
 
             for (size_t i = 0; i < moves.size(); ++i) {
-                board.set(moves[i], currentCell);
-                int score = minimax(board, depth - 1, alpha, beta,
+                place(board, moves[i], currentCell);
+                int score = minimax(board, moves[i], depth - 1, alpha, beta,
                                     getOpponent(currentPlayer), true);
-                board.set(moves[i], CellState::Empty);
+                place(board, moves[i], CellState::Empty);
 
                 bestScore = std::min(bestScore, score);
                 beta = std::min(beta, bestScore);
 
                 if (beta <= alpha) {
+                    AI_PROFILE_ONLY(stats_.profile.recordCutoff(i);)
                     break;
                 }
             }
         }
 
-        // Сохранение в кеш
-        if (useMemoization_) {
-            transpositionTable_.insert(board.hash(), bestScore);
+        // Сохранение в кеш (оценку прерванного поиска сохранять нельзя)
+        if (useMemoization_ && !aborted_) {
+            AI_PROFILE_SCOPE(stats_.profile, TTStore);
+            TTEntry::Bound bound = bestScore <= alphaOrig ? TTEntry::Upper
+                                 : bestScore >= betaOrig ? TTEntry::Lower
+                                 : TTEntry::Exact;
+            table_->insert_or_assign(hash, toTable(bestScore, depth, bound));
         }
 
         return bestScore;
     }
 
-public:
-    MinimaxAI(Player player, int maxDepth = 9, bool useMemoization = true)
-        : player_(player),
-          opponent_(getOpponent(player)),
-          maxDepth_(maxDepth),
-          useMemoization_(useMemoization) {}
-
-    MoveEvaluation findBestMove(Board& board) {
-        stats_.reset();
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        DynamicArray<Coord> moves = board.getEmptyCells();
-        if (moves.empty()) {
-            return MoveEvaluation();
-        }
-
-        // Если доска пустая — ходим в центр
-        if (moves.size() == static_cast<size_t>(board.getSize() * board.getSize())) {
-            int center = board.getSize() / 2;
-            stats_.timeMs = 0;
-            return MoveEvaluation(Coord(center, center), 0);
-        }
-
+    // Один проход от корня на глубину depth в уже выбранной таблице table_.
+    // Прерванный проход возвращает лучшее из успевшего, aborted_ == true.
+    MoveEvaluation searchRoot(Board& board, const MoveList& moves, int depth) {
         MoveEvaluation bestMove;
         bestMove.score = std::numeric_limits<int>::min();
         CellState playerCell = playerToCell(player_);
+        searchDepth_ = depth;
+        AI_PROFILE_ONLY(stats_.profile.recordNode(0);)
+        AI_PROFILE_ONLY(stats_.profile.expandedNodes++;)
 
         int alpha = std::numeric_limits<int>::min();
         int beta = std::numeric_limits<int>::max();
 
         for (size_t i = 0; i < moves.size(); ++i) {
-            board.set(moves[i], playerCell);
+            TraceSpan span("rootMove");
+            span.arg("cell", moves[i].row * board.getSize() + moves[i].col);
+            place(board, moves[i], playerCell);
 
-            int score = minimax(board, maxDepth_ - 1, alpha, beta,
+            int score = minimax(board, moves[i], depth - 1, alpha, beta,
                                 opponent_, false);
 
-            board.set(moves[i], CellState::Empty);
+            place(board, moves[i], CellState::Empty);
+            if (aborted_) {
+                break;
+            }
+            span.arg("score", score);
 
             if (score > bestMove.score) {
                 bestMove.score = score;
@@ -241,13 +696,204 @@ public:
             alpha = std::max(alpha, score);
         }
 
+        return bestMove;
+    }
+
+    // Поиск от корня: сразу на maxDepth_ или, при iterative_,
+    // итеративным углублением 1..maxDepth_ до прерывания
+    MoveEvaluation search(Board& board) {
+        stats_.reset();
+        auto startTime = std::chrono::high_resolution_clock::now();
+        size_t evictionsBefore = table_->evictions();
+        table_->resetStats();
+        aborted_ = false;
+
+        if (board.isFull()) {
+            return MoveEvaluation();
+        }
+
+        // Если доска пустая — ходим в центр
+        if (board.stoneCount() == 0) {
+            int center = board.getSize() / 2;
+            stats_.timeMs = 0;
+            stats_.depthReached = maxDepth_;
+            return MoveEvaluation(Coord(center, center), 0);
+        }
+
+        // Таблицы образцов строятся один раз на длину линии, полная
+        // сумма окон — один раз на поиск
+        patternActive_ = evaluator_ == Evaluator::Pattern
+                      && PatternEvaluator::supports(board.getWinLength());
+        if (patternActive_) {
+            patterns_.prepare(board.getWinLength());
+            patternScore_ = patterns_.evaluate(board);
+        }
+        fullWinCheck_ = board.checkWin(CellState::X) || board.checkWin(CellState::O);
+        // Корень перебирает те же ходы, что и узлы: на большом поле —
+        // только рядом с фишками, без полного списка пустых клеток
+        prepareMoveGeneration(board);
+        MoveList moves = generateMoves(board);
+
+        MoveEvaluation bestMove(moves[0], 0);
+        if (!iterative_) {
+            MoveEvaluation result = searchRoot(board, moves, maxDepth_);
+            if (result.score != std::numeric_limits<int>::min()) {
+                bestMove = result;
+            }
+            if (!aborted_) {
+                stats_.depthReached = maxDepth_;
+            }
+        } else {
+            for (int depth = 1; depth <= maxDepth_; ++depth) {
+                TraceSpan span("iteration");
+                span.arg("depth", depth);
+                MoveEvaluation result = searchRoot(board, moves, depth);
+                if (aborted_) {
+                    break;
+                }
+                bestMove = result;
+                stats_.depthReached = depth;
+                span.arg("score", result.score);
+
+                // Лучший ход прошлой итерации перебирается первым:
+                // окно alpha сужается сразу и отсечений больше
+                for (size_t i = 1; i < moves.size(); ++i) {
+                    if (moves[i] == result.move) {
+                        std::swap(moves[0], moves[i]);
+                        break;
+                    }
+                }
+                // Форсированный выигрыш или проигрыш глубже не изменится
+                if (std::abs(result.score) >= WIN_SCORE) {
+                    break;
+                }
+            }
+        }
+        stats_.stopped = aborted_;
+
         auto endTime = std::chrono::high_resolution_clock::now();
         stats_.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
             endTime - startTime).count();
+        stats_.cacheEvictions = table_->evictions() - evictionsBefore;
+        if (useMemoization_) {
+            stats_.cache = table_->stats();
+        }
 
         return bestMove;
     }
 
+    // Перестройки транспозиционной таблицы — отдельные отрезки трассировки.
+    // Одна перестройка не начинается внутри другой, так что на поток
+    // хватает одного отрезка
+    static std::optional<TraceSpan>& rehashSpan() {
+        thread_local std::optional<TraceSpan> span;
+        return span;
+    }
+
+    static void traceRehashBegin(const char* operation, size_t capacity) {
+        std::optional<TraceSpan>& span = rehashSpan();
+        span.emplace(operation);
+        span->arg("capacity", static_cast<int64_t>(capacity));
+    }
+
+    static void traceRehashEnd() {
+        rehashSpan().reset();
+    }
+
+    static void traceRehashes(HashMap<size_t, TTEntry>& table) {
+        table.setRehashHook({&traceRehashBegin, &traceRehashEnd});
+    }
+
+    // Поиск в постоянной таблице или в таблице из арены
+    MoveEvaluation runSearch(Board& board) {
+        if (persistentCache_) {
+            table_ = &transpositionTable_;
+            MoveEvaluation result = search(board);
+            table_ = nullptr;
+            return result;
+        }
+
+        MoveEvaluation result;
+        {
+            HashMap<size_t, TTEntry> searchTable(searchArena_);
+            searchTable.setIncrementalRehash(true);
+            traceRehashes(searchTable);
+            searchTable.setMaxEntries(cacheLimit_);
+            table_ = &searchTable;
+            result = search(board);
+            table_ = nullptr;
+        }
+        // Таблица уже разрушена — вся её память возвращается разом
+        searchArena_.reset();
+        return result;
+    }
+
+public:
+    MinimaxAI(Player player, int maxDepth = 9, bool useMemoization = true)
+        : player_(player),
+          opponent_(getOpponent(player)),
+          maxDepth_(maxDepth),
+          searchDepth_(maxDepth),
+          iterative_(false),
+          useMemoization_(useMemoization),
+          evaluator_(Evaluator::Center),
+          patternActive_(false),
+          patternScore_(0),
+          moveRadius_(0),
+          markEpoch_(0),
+          fullWinCheck_(false),
+          persistentCache_(true),
+          cacheLimit_(0),
+          table_(nullptr),
+          stopRequested_(false),
+          aborted_(false),
+          hasDeadline_(false) {
+        // Рост таблицы посреди поиска не должен давать пауз в десятки мс
+        transpositionTable_.setIncrementalRehash(true);
+        traceRehashes(transpositionTable_);
+    }
+
+    MoveEvaluation findBestMove(Board& board) {
+        TraceSpan span("findBestMove");
+        span.arg("depth", maxDepth_);
+        MoveEvaluation result;
+        if (perf_.isOpen()) {
+            perf_.start();
+            result = runSearch(board);
+            stats_.hardware = perf_.stop();
+        } else {
+            result = runSearch(board);
+        }
+        // Флаг сбрасывается после поиска, а не перед ним: stop(),
+        // пришедший до начала поиска, не должен потеряться
+        stopRequested_.store(false, std::memory_order_relaxed);
+        span.arg("nodes", static_cast<int64_t>(stats_.nodesVisited));
+        return result;
+    }
+
+    // Итеративное углубление 1..maxDepth_ с лимитом времени (0 — без
+    // лимита, до maxDepth_ или stop()). Возвращает ход последней
+    // завершённой итерации; глубина — в getStatistics().depthReached.
+    MoveEvaluation findBestMoveTimed(Board& board, std::chrono::milliseconds timeLimit) {
+        iterative_ = true;
+        hasDeadline_ = timeLimit.count() > 0;
+        deadline_ = std::chrono::steady_clock::now() + timeLimit;
+        MoveEvaluation result = findBestMove(board);
+        iterative_ = false;
+        hasDeadline_ = false;
+        return result;
+    }
+
+    // Прерывает идущий поиск; можно звать из любого потока. Если поиска
+    // ещё нет, прерван будет следующий — до clearStop().
+    void stop() {
+        stopRequested_.store(true, std::memory_order_relaxed);
+    }
+
+    void clearStop() {
+        stopRequested_.store(false, std::memory_order_relaxed);
+    }
+
     const AIStatistics& getStatistics() const {
         return stats_;
     }
@@ -256,7 +902,84 @@ public:
         transpositionTable_.clear();
     }
 
+    void setMaxDepth(int depth) {
+        maxDepth_ = depth;
+    }
+
+    int getMaxDepth() const {
+        return maxDepth_;
+    }
+
+    // Оценки разных эвристик в одной таблице несравнимы — при смене
+    // эвристики постоянная таблица очищается
+    void setEvaluator(Evaluator evaluator) {
+        if (evaluator != evaluator_) {
+            evaluator_ = evaluator;
+            transpositionTable_.clear();
+        }
+    }
+
+    Evaluator getEvaluator() const {
+        return evaluator_;
+    }
+
+    // Большие поля: ходы только на клетках не дальше radius от фишек
+    // (0 — все пустые клетки, по умолчанию). Выигрыш и защита от него
+    // всегда рядом с фишками, так что radius 1 их не теряет. Оценки в
+    // таблице получены на другом наборе ходов, поэтому при смене радиуса
+    // таблица сбрасывается, как и при смене оценки.
+    void setMoveRadius(int radius) {
+        radius = radius > 0 ? radius : 0;
+        if (radius != moveRadius_) {
+            moveRadius_ = radius;
+            transpositionTable_.clear();
+        }
+    }
+
+    int getMoveRadius() const {
+        return moveRadius_;
+    }
+
+    // Режим большой доски: ходы рядом с фишками и оценка образцами
+    void setLargeBoardMode() {
+        setMoveRadius(LARGE_BOARD_MOVE_RADIUS);
+        setEvaluator(Evaluator::Pattern);
+    }
+
     void setUseMemoization(bool use) {
         useMemoization_ = use;
     }
+
+    // Потолок размера транспозиционной таблицы (0 — без ограничения).
+    // При заполнении старые позиции вытесняются, память не растёт.
+    void setCacheLimit(size_t maxEntries) {
+        cacheLimit_ = maxEntries;
+        transpositionTable_.setMaxEntries(maxEntries);
+    }
+
+    // false — транспозиционная таблица заводится заново на каждый поиск
+    // в арене и не переживает findBestMove; true (по умолчанию) — общая
+    // таблица на всю партию
+    void setPersistentCache(bool persistent) {
+        persistentCache_ = persistent;
+    }
+
+    // Включает замер аппаратных счётчиков на каждый поиск.
+    // Возвращает false, если ни один счётчик недоступен (не Linux,
+    // нет прав, контейнер без perf) — тогда поиск идёт как обычно.
+    bool setHardwareCounters(bool enable) {
+        if (!enable) {
+            perf_.close();
+            return false;
+        }
+        return perf_.open();
+    }
+
+    const std::string& hardwareCountersError() const {
+        return perf_.error();
+    }
+
+    const MonotonicArena& searchArena() const {
+        return searchArena_;
+    }
 };
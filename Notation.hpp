@@ -0,0 +1,155 @@
+// Notation.hpp
+#pragma once
+#include "Board.hpp"
+#include <sstream>
+#include <string>
+
+// Текстовая запись позиции по мотивам FEN — одна строка:
+//
+//   SIZE WIN ROWS SIDE        например: 3 3 X1O/1X1/3 O
+//
+// ROWS — строки поля сверху вниз через '/', в строке X и O — фишки,
+// число — столько пустых клеток подряд. SIDE — кто ходит (X или O);
+// если его нет, очередь выводится из числа фишек (первым ходит X).
+namespace notation {
+
+// Чья очередь по числу фишек; Empty — такой позиции в игре не бывает
+inline CellState sideToMove(const Board& board) {
+    int x = 0;
+    int o = 0;
+    for (int row = 0; row < board.getSize(); ++row) {
+        for (int col = 0; col < board.getSize(); ++col) {
+            CellState cell = board.get(row, col);
+            x += cell == CellState::X;
+            o += cell == CellState::O;
+        }
+    }
+    if (x == o) {
+        return CellState::X;
+    }
+    return x == o + 1 ? CellState::O : CellState::Empty;
+}
+
+inline std::string toText(const Board& board, CellState side) {
+    std::string text = std::to_string(board.getSize()) + " "
+                     + std::to_string(board.getWinLength()) + " ";
+    for (int row = 0; row < board.getSize(); ++row) {
+        if (row > 0) {
+            text += '/';
+        }
+        int empty = 0;
+        for (int col = 0; col < board.getSize(); ++col) {
+            CellState cell = board.get(row, col);
+            if (cell == CellState::Empty) {
+                ++empty;
+                continue;
+            }
+            if (empty > 0) {
+                text += std::to_string(empty);
+                empty = 0;
+            }
+            text += static_cast<char>(cell);
+        }
+        if (empty > 0) {
+            text += std::to_string(empty);
+        }
+    }
+    text += ' ';
+    text += static_cast<char>(side);
+    return text;
+}
+
+inline std::string toText(const Board& board) {
+    CellState side = sideToMove(board);
+    return toText(board, side == CellState::Empty ? CellState::X : side);
+}
+
+// Разбор строки; при ошибке board и side не меняются, а в error
+// (если задан) — причина
+inline bool parse(const std::string& text, Board& board, CellState& side,
+                  std::string* error = nullptr) {
+    auto fail = [error](const std::string& reason) {
+        if (error != nullptr) {
+            *error = reason;
+        }
+        return false;
+    };
+
+    std::istringstream in(text);
+    int size = 0;
+    int winLength = 0;
+    std::string rows;
+    if (!(in >> size >> winLength >> rows)) {
+        return fail("ожидается: SIZE WIN ROWS [SIDE]");
+    }
+    if (size < 3 || size > MAX_BOARD_SIZE || winLength < 3 || winLength > size) {
+        return fail("недопустимые размер поля или длина линии");
+    }
+
+    Board parsed(size, winLength);
+    int row = 0;
+    int col = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        char c = rows[i];
+        if (c == '/') {
+            if (col != size) {
+                return fail("строка " + std::to_string(row + 1) + ": не " + std::to_string(size)
+                            + " клеток");
+            }
+            ++row;
+            col = 0;
+            if (row >= size) {
+                return fail("строк больше, чем " + std::to_string(size));
+            }
+        } else if (c >= '0' && c <= '9') {
+            int run = 0;
+            while (i < rows.size() && rows[i] >= '0' && rows[i] <= '9') {
+                run = run * 10 + (rows[i] - '0');
+                ++i;
+                if (run > size) {
+                    break;
+                }
+            }
+            --i;
+            if (run == 0 || col + run > size) {
+                return fail("строка " + std::to_string(row + 1) + ": лишние клетки");
+            }
+            col += run;
+        } else if (c == 'X' || c == 'O' || c == 'x' || c == 'o') {
+            if (col >= size) {
+                return fail("строка " + std::to_string(row + 1) + ": лишние клетки");
+            }
+            parsed.set(row, col++, (c == 'X' || c == 'x') ? CellState::X : CellState::O);
+        } else {
+            return fail(std::string("недопустимый символ '") + c + "'");
+        }
+    }
+    if (row != size - 1 || col != size) {
+        return fail("поле описано не полностью");
+    }
+
+    CellState expected = sideToMove(parsed);
+    if (expected == CellState::Empty) {
+        return fail("число фишек X и O не бывает в партии");
+    }
+    CellState parsedSide = expected;
+    std::string sideText;
+    if (in >> sideText) {
+        if (sideText == "X" || sideText == "x") {
+            parsedSide = CellState::X;
+        } else if (sideText == "O" || sideText == "o") {
+            parsedSide = CellState::O;
+        } else {
+            return fail("ходить может только X или O");
+        }
+        if (parsedSide != expected) {
+            return fail("очередь хода не сходится с числом фишек");
+        }
+    }
+
+    board = parsed;
+    side = parsedSide;
+    return true;
+}
+
+} // namespace notation
@@ -0,0 +1,155 @@
+// PatternEval.hpp
+#pragma once
+#include "Board.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Оценка позиции по образцам в окнах линии. Окно — winLength клеток
+// подряд по строке, столбцу или диагонали; его содержимое кодируется
+// числом в троичной системе (пусто 0, X 1, O 2, первая клетка окна —
+// младший разряд), а оценка окна берётся из таблицы на 3^winLength
+// кодов, построенной один раз на длину линии.
+//
+// В окне только одна сторона: чем больше её фишек, тем выше оценка
+// (1, 4, 16, ... за 1, 2, 3, ... фишки). Окно с обеими сторонами —
+// мёртвое, 0. Открытая тройка (_XXX_ при длине 4) попадает в два окна
+// с тремя X, закрытая (OXXX_) — в одно, так что открытые и закрытые
+// варианты различаются сами собой.
+//
+// Сумма окон меняется только в окнах через изменённую клетку, поэтому
+// кроме полной оценки есть delta() — приращение при ходе или откате;
+// поиск ведёт сумму по ним и в листе ничего не пересчитывает.
+// Оценка — со стороны X.
+class PatternEvaluator {
+public:
+    // 3^10 = 59049 кодов; для длиннее таблица не строится
+    static constexpr int MAX_LENGTH = 10;
+
+private:
+    static constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+    int winLength_;
+    std::vector<int> table_;    // оценка окна по его коду
+    std::vector<int> power_;    // 3^i
+
+    static int digit(CellState cell) {
+        return cell == CellState::X ? 1 : cell == CellState::O ? 2 : 0;
+    }
+
+    static int windowValue(int stones) {
+        return stones == 0 ? 0 : 1 << (2 * (stones - 1));
+    }
+
+public:
+    PatternEvaluator() : winLength_(0) {}
+
+    static bool supports(int winLength) {
+        return winLength >= 1 && winLength <= MAX_LENGTH;
+    }
+
+    int winLength() const { return winLength_; }
+
+    // Строит таблицы под длину линии; повторный вызов с той же длиной
+    // ничего не делает
+    void prepare(int winLength) {
+        if (winLength == winLength_ || !supports(winLength)) {
+            return;
+        }
+        winLength_ = winLength;
+        power_.assign(static_cast<size_t>(winLength) + 1, 1);
+        for (int i = 1; i <= winLength; ++i) {
+            power_[i] = power_[i - 1] * 3;
+        }
+
+        table_.assign(static_cast<size_t>(power_[winLength]), 0);
+        for (int code = 0; code < power_[winLength]; ++code) {
+            int x = 0;
+            int o = 0;
+            for (int rest = code; rest > 0; rest /= 3) {
+                x += rest % 3 == 1;
+                o += rest % 3 == 2;
+            }
+            if (x == 0) {
+                table_[code] = -windowValue(o);
+            } else if (o == 0) {
+                table_[code] = windowValue(x);
+            }
+        }
+    }
+
+    int windowScore(int code) const {
+        return table_[code];
+    }
+
+    // Полная оценка: все окна всех линий, код окна сдвигается на клетку
+    // за шаг, а не собирается заново
+    int evaluate(const Board& board) const {
+        int size = board.getSize();
+        int top = power_[winLength_ - 1];
+        int score = 0;
+        for (const auto& dir : DIRECTIONS) {
+            for (int row = 0; row < size; ++row) {
+                for (int col = 0; col < size; ++col) {
+                    // Начало линии: шаг назад выводит за поле
+                    int prevRow = row - dir[0];
+                    int prevCol = col - dir[1];
+                    if (prevRow >= 0 && prevCol >= 0 && prevCol < size) {
+                        continue;
+                    }
+                    int code = 0;
+                    int length = 0;
+                    for (int r = row, c = col; r < size && c >= 0 && c < size;
+                         r += dir[0], c += dir[1]) {
+                        code = code / 3 + digit(board.get(r, c)) * top;
+                        if (++length >= winLength_) {
+                            score += table_[code];
+                        }
+                    }
+                }
+            }
+        }
+        return score;
+    }
+
+    // На сколько изменится evaluate(), если в клетку (row, col) поставить
+    // cell (или Empty — откат). Зовётся до board.set.
+    int delta(const Board& board, int row, int col, CellState cell) const {
+        int size = board.getSize();
+        int change = digit(cell) - digit(board.get(row, col));
+        if (change == 0) {
+            return 0;
+        }
+        int top = power_[winLength_ - 1];
+        int result = 0;
+        for (const auto& dir : DIRECTIONS) {
+            // Самая дальняя назад клетка линии, чьё окно ещё накрывает (row, col)
+            int back = 0;
+            while (back < winLength_ - 1) {
+                int r = row - (back + 1) * dir[0];
+                int c = col - (back + 1) * dir[1];
+                if (r < 0 || c < 0 || c >= size) {
+                    break;
+                }
+                ++back;
+            }
+            int code = 0;
+            int length = 0;
+            for (int offset = -back; offset < winLength_; ++offset) {
+                int r = row + offset * dir[0];
+                int c = col + offset * dir[1];
+                if (r >= size || c < 0 || c >= size) {
+                    break;
+                }
+                code = code / 3 + digit(board.get(r, c)) * top;
+                if (++length >= winLength_) {
+                    // Окно [offset - winLength_ + 1, offset]; клетка в нём
+                    // на позиции -(начало окна)
+                    int position = winLength_ - 1 - offset;
+                    result += table_[code + change * power_[position]] - table_[code];
+                }
+            }
+        }
+        return result;
+    }
+};
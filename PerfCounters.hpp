@@ -0,0 +1,197 @@
+// PerfCounters.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Показания аппаратных счётчиков за один замер. Счётчик, который
+// не удалось открыть (нет прав, нет поддержки в ВМ/контейнере),
+// помечается недоступным, а производные величины для него равны 0.
+struct HardwareCounters {
+    enum Counter {
+        Cycles,
+        Instructions,
+        Branches,
+        BranchMisses,
+        L1DLoads,
+        L1DMisses,
+        LLCReferences,
+        LLCMisses,
+        COUNTER_COUNT
+    };
+
+    uint64_t values[COUNTER_COUNT];
+    uint32_t validMask;   // бит i — счётчик i действительно измерен
+
+    HardwareCounters() : values(), validMask(0) {}
+
+    bool available() const { return validMask != 0; }
+
+    bool has(Counter counter) const {
+        return (validMask & (1u << counter)) != 0;
+    }
+
+    uint64_t get(Counter counter) const {
+        return has(counter) ? values[counter] : 0;
+    }
+
+    double ratio(Counter numerator, Counter denominator) const {
+        if (!has(numerator) || !has(denominator) || values[denominator] == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(values[numerator])
+               / static_cast<double>(values[denominator]);
+    }
+
+    double ipc() const { return ratio(Instructions, Cycles); }
+    double branchMissRate() const { return ratio(BranchMisses, Branches); }
+    double l1dMissRate() const { return ratio(L1DMisses, L1DLoads); }
+    double llcMissRate() const { return ratio(LLCMisses, LLCReferences); }
+};
+
+// Сборщик на perf_event_open (только Linux). Счётчики открываются
+// по отдельности, а не группой: если часть событий недоступна,
+// остальные всё равно считаются. Меряется только пользовательский
+// код текущего потока. На других ОС open() всегда возвращает false.
+class PerfCounters {
+private:
+    int fds_[HardwareCounters::COUNTER_COUNT];
+    std::string error_;
+
+#ifdef __linux__
+    static long perfEventOpen(perf_event_attr* attr) {
+        return syscall(__NR_perf_event_open, attr, 0, -1, -1, 0);
+    }
+
+    static uint64_t cacheConfig(uint64_t cache, uint64_t result) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+    }
+
+    int openCounter(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // Для поправки на мультиплексирование, когда счётчиков не хватает
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        long fd = perfEventOpen(&attr);
+        if (fd < 0 && error_.empty()) {
+            error_ = std::strerror(errno);
+        }
+        return static_cast<int>(fd);
+    }
+#endif
+
+public:
+    PerfCounters() {
+        for (int& fd : fds_) {
+            fd = -1;
+        }
+    }
+
+    ~PerfCounters() { close(); }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // true, если открылся хотя бы один счётчик
+    bool open() {
+        close();
+        error_.clear();
+#ifdef __linux__
+        fds_[HardwareCounters::Cycles] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds_[HardwareCounters::Instructions] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds_[HardwareCounters::Branches] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS);
+        fds_[HardwareCounters::BranchMisses] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds_[HardwareCounters::L1DLoads] = openCounter(PERF_TYPE_HW_CACHE,
+            cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_ACCESS));
+        fds_[HardwareCounters::L1DMisses] = openCounter(PERF_TYPE_HW_CACHE,
+            cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS));
+        fds_[HardwareCounters::LLCReferences] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+        fds_[HardwareCounters::LLCMisses] =
+            openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#else
+        error_ = "perf_event_open is only available on Linux";
+#endif
+        return isOpen();
+    }
+
+    void close() {
+        for (int& fd : fds_) {
+#ifdef __linux__
+            if (fd >= 0) {
+                ::close(fd);
+            }
+#endif
+            fd = -1;
+        }
+    }
+
+    bool isOpen() const {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Причина, по которой первый недоступный счётчик не открылся
+    const std::string& error() const { return error_; }
+
+    void start() {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    HardwareCounters stop() {
+        HardwareCounters result;
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (int i = 0; i < HardwareCounters::COUNTER_COUNT; ++i) {
+            if (fds_[i] < 0) {
+                continue;
+            }
+            // value, time_enabled, time_running
+            uint64_t data[3];
+            if (read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))
+                || data[2] == 0) {
+                continue;
+            }
+            double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+            result.values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * scale);
+            result.validMask |= 1u << i;
+        }
+#endif
+        return result;
+    }
+};
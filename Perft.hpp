@@ -0,0 +1,149 @@
+// Perft.hpp
+#pragma once
+#include "Board.hpp"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Perft — полный перебор дерева игры до заданной глубины без всякой
+// эвристики: только ход, откат, генерация ходов и проверка победы.
+// Лист — позиция на глубине depth или терминальная позиция раньше
+// (победа последнего ходившего или заполненное поле).
+//
+// Шаблон работает с любой доской с интерфейсом Board (get/set,
+// getEmptyCells, checkWinAt) — так быстрые реализации доски проверяются
+// и на скорость, и на точное совпадение числа листьев.
+namespace perft {
+
+inline CellState cellFor(bool xToMove) {
+    return xToMove ? CellState::X : CellState::O;
+}
+
+template<typename B>
+uint64_t countLeaves(B& board, int depth, bool xToMove) {
+    if (depth == 0) {
+        return 1;
+    }
+
+    MoveList moves = board.getEmptyCells();
+    if (moves.empty()) {
+        return 1;
+    }
+
+    CellState cell = cellFor(xToMove);
+    uint64_t leaves = 0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        board.set(moves[i], cell);
+        // Выиграть мог только тот, кто сейчас сходил, и только линией
+        // через свою клетку
+        if (board.checkWinAt(moves[i])) {
+            ++leaves;
+        } else {
+            leaves += countLeaves(board, depth - 1, !xToMove);
+        }
+        board.set(moves[i], CellState::Empty);
+    }
+    return leaves;
+}
+
+struct RootMoveCount {
+    Coord move;
+    uint64_t leaves;
+};
+
+// Листья под каждым ходом из корня. Ходы корня раздаются потокам
+// по одному через атомарный счётчик; у каждого потока своя копия доски.
+template<typename B>
+std::vector<RootMoveCount> countByRootMove(const B& root, int depth, bool xToMove,
+                                           unsigned threads = 1) {
+    MoveList moves = root.getEmptyCells();
+    std::vector<RootMoveCount> result(moves.size());
+    for (size_t i = 0; i < moves.size(); ++i) {
+        result[i].move = moves[i];
+        result[i].leaves = 0;
+    }
+    if (depth <= 0) {
+        return result;
+    }
+
+    CellState cell = cellFor(xToMove);
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        B board = root;
+        for (size_t i = next.fetch_add(1); i < result.size(); i = next.fetch_add(1)) {
+            board.set(result[i].move, cell);
+            result[i].leaves = board.checkWinAt(result[i].move)
+                ? 1
+                : countLeaves(board, depth - 1, !xToMove);
+            board.set(result[i].move, CellState::Empty);
+        }
+    };
+
+    if (threads <= 1) {
+        worker();
+        return result;
+    }
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    return result;
+}
+
+// Эталонные значения для пустого поля, первым ходит X
+struct KnownValue {
+    int size;
+    int winLength;
+    int depth;
+    uint64_t leaves;
+};
+
+// 3x3: известное число всех партий — 255168 (выигрыши на ходах 5..9
+// плюс 46080 ничьих). 4x4 с линией 4: до 7-го хода побед нет,
+// так что листья — это просто размещения 16 * 15 * ...; эти значения
+// проверяют только генерацию ходов. 4x4 с линией 3: первые победы на
+// 5-м ходу, и с глубины 6 листьев меньше размещений (5541120 против
+// 5765760) — здесь проверяются checkWinAt и обрыв ветки на победе.
+inline const std::vector<KnownValue>& knownValues() {
+    static const std::vector<KnownValue> values = {
+        {3, 3, 1, 9},
+        {3, 3, 2, 72},
+        {3, 3, 3, 504},
+        {3, 3, 4, 3024},
+        {3, 3, 5, 15120},
+        {3, 3, 6, 56160},
+        {3, 3, 7, 154944},
+        {3, 3, 8, 255168},
+        {3, 3, 9, 255168},
+        {4, 4, 1, 16},
+        {4, 4, 2, 240},
+        {4, 4, 3, 3360},
+        {4, 4, 4, 43680},
+        {4, 4, 5, 524160},
+        {4, 4, 6, 5765760},
+        {4, 3, 1, 16},
+        {4, 3, 2, 240},
+        {4, 3, 3, 3360},
+        {4, 3, 4, 43680},
+        {4, 3, 5, 524160},
+        {4, 3, 6, 5541120},
+        {4, 3, 7, 53077104},
+    };
+    return values;
+}
+
+// Эталон для (size, winLength, depth) или 0, если он неизвестен
+inline uint64_t knownLeaves(int size, int winLength, int depth) {
+    for (const KnownValue& value : knownValues()) {
+        if (value.size == size && value.winLength == winLength && value.depth == depth) {
+            return value.leaves;
+        }
+    }
+    return 0;
+}
+
+} // namespace perft
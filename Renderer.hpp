@@ -0,0 +1,154 @@
+// Renderer.hpp
+#pragma once
+#include "Board.hpp"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+// Отрисовка партии в терминале без мерцания. Кадр собирается в одну
+// строку и выводится одной записью. Первый кадр — всё поле целиком
+// (Board::toString), дальше — только изменившиеся клетки и строки
+// состояния под полем, через позиционирование курсора ANSI.
+// Без ANSI (старая консоль Windows) каждый кадр печатается целиком.
+//
+// Раскладка экрана (строки с 1): 1 — номера столбцов, далее строки
+// поля через строку-разделитель, клетка (r, c) — в строке 2 + 2r,
+// столбце w + 2 + 2c, где w — Board::labelWidth(); после пустой
+// строки — строки состояния.
+class TerminalRenderer {
+private:
+    std::ostream& out_;
+    bool ansi_;
+    bool drawn_;              // на экране уже есть полный кадр
+    int size_;
+    std::vector<char> cells_; // что сейчас на экране
+    std::vector<std::string> status_;
+    int renderEvery_;
+    std::string frame_;       // буфер кадра, переиспользуется
+    size_t frames_;
+    size_t bytes_;
+
+    int statusLine(size_t i) const {
+        return 2 * size_ + 2 + static_cast<int>(i);
+    }
+
+    void moveTo(int line, int column) {
+        frame_ += "\x1b[";
+        frame_ += std::to_string(line);
+        frame_ += ';';
+        frame_ += std::to_string(column);
+        frame_ += 'H';
+    }
+
+    void fullFrame(const Board& board, const std::vector<std::string>& status) {
+        if (ansi_) {
+            frame_ += "\x1b[2J\x1b[H";
+        }
+        frame_ += board.toString();
+        frame_ += '\n';
+        for (const std::string& line : status) {
+            frame_ += line;
+            frame_ += '\n';
+        }
+    }
+
+    void diffFrame(const Board& board, const std::vector<std::string>& status) {
+        for (int row = 0; row < size_; ++row) {
+            for (int col = 0; col < size_; ++col) {
+                char cell = static_cast<char>(board.get(row, col));
+                if (cells_[row * size_ + col] != cell) {
+                    moveTo(2 + 2 * row, board.labelWidth() + 2 + 2 * col);
+                    frame_ += cell;
+                }
+            }
+        }
+        for (size_t i = 0; i < status.size(); ++i) {
+            if (i >= status_.size() || status_[i] != status[i]) {
+                moveTo(statusLine(i), 1);
+                frame_ += "\x1b[2K";
+                frame_ += status[i];
+            }
+        }
+        // Под кадром — чистый экран: стираются лишние старые строки
+        // состояния и всё, что печаталось между кадрами (подсказки)
+        moveTo(statusLine(status.size()), 1);
+        frame_ += "\x1b[J";
+    }
+
+public:
+    explicit TerminalRenderer(std::ostream& out, bool ansi = enableAnsi())
+        : out_(out),
+          ansi_(ansi),
+          drawn_(false),
+          size_(0),
+          renderEvery_(1),
+          frames_(0),
+          bytes_(0) {}
+
+    TerminalRenderer(const TerminalRenderer&) = delete;
+    TerminalRenderer& operator=(const TerminalRenderer&) = delete;
+
+    // Включает разбор ANSI в консоли Windows; в остальных терминалах
+    // он и так есть
+    static bool enableAnsi() {
+#ifdef _WIN32
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode = 0;
+        if (console == INVALID_HANDLE_VALUE || !GetConsoleMode(console, &mode)) {
+            return false;
+        }
+        return SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) != 0;
+#else
+        return true;
+#endif
+    }
+
+    // Быстрый показ ИИ vs ИИ: рисовать только каждый n-й ход
+    void setRenderEvery(int n) {
+        renderEvery_ = n > 1 ? n : 1;
+    }
+
+    bool shouldRender(int moveNumber) const {
+        return moveNumber % renderEvery_ == 0;
+    }
+
+    // Экран испорчен посторонним выводом — следующий кадр полный
+    void invalidate() {
+        drawn_ = false;
+    }
+
+    void render(const Board& board, const std::vector<std::string>& status) {
+        frame_.clear();
+        if (!ansi_ || !drawn_ || board.getSize() != size_) {
+            size_ = board.getSize();
+            fullFrame(board, status);
+            drawn_ = true;
+        } else {
+            diffFrame(board, status);
+        }
+
+        cells_.resize(static_cast<size_t>(size_ * size_));
+        for (int row = 0; row < size_; ++row) {
+            for (int col = 0; col < size_; ++col) {
+                cells_[row * size_ + col] = static_cast<char>(board.get(row, col));
+            }
+        }
+        status_ = status;
+
+        out_.write(frame_.data(), static_cast<std::streamsize>(frame_.size()));
+        out_.flush();
+        ++frames_;
+        bytes_ += frame_.size();
+    }
+
+    size_t framesRendered() const { return frames_; }
+    size_t bytesWritten() const { return bytes_; }
+};
@@ -0,0 +1,204 @@
+// SmallArray.hpp
+#pragma once
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Массив с тем же интерфейсом, что и DynamicArray, но первые N элементов
+// хранятся прямо в объекте. В кучу он уходит только при переполнении,
+// поэтому короткие временные списки (ходы, стеки отмены) обходятся без
+// выделений памяти.
+template<typename T, size_t N>
+class SmallArray {
+    static_assert(N > 0, "SmallArray needs inline capacity");
+
+private:
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+
+    T* inlineData() { return reinterpret_cast<T*>(inline_); }
+
+    bool isInline() const {
+        return data_ == reinterpret_cast<const T*>(inline_);
+    }
+
+    void destroyRange(size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) {
+            data_[i].~T();
+        }
+    }
+
+    void releaseHeap() {
+        if (!isInline()) {
+            ::operator delete(data_);
+        }
+    }
+
+    void reallocate(size_t newCapacity) {
+        T* newData = static_cast<T*>(::operator new(sizeof(T) * newCapacity));
+        for (size_t i = 0; i < size_; ++i) {
+            new (&newData[i]) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        releaseHeap();
+        data_ = newData;
+        capacity_ = newCapacity;
+    }
+
+    // Забирает содержимое other: кучу — целиком, встроенный буфер — поэлементно
+    void takeFrom(SmallArray& other) {
+        if (other.isInline()) {
+            for (size_t i = 0; i < other.size_; ++i) {
+                new (&data_[i]) T(std::move(other.data_[i]));
+            }
+            size_ = other.size_;
+            other.clear();
+        } else {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inlineData();
+            other.size_ = 0;
+            other.capacity_ = N;
+        }
+    }
+
+public:
+    SmallArray() : data_(inlineData()), size_(0), capacity_(N) {}
+
+    ~SmallArray() {
+        destroyRange(0, size_);
+        releaseHeap();
+    }
+
+    SmallArray(const SmallArray& other) : data_(inlineData()), size_(0), capacity_(N) {
+        reserve(other.size_);
+        for (; size_ < other.size_; ++size_) {
+            new (&data_[size_]) T(other.data_[size_]);
+        }
+    }
+
+    SmallArray(SmallArray&& other) noexcept : data_(inlineData()), size_(0), capacity_(N) {
+        takeFrom(other);
+    }
+
+    SmallArray& operator=(const SmallArray& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            for (; size_ < other.size_; ++size_) {
+                new (&data_[size_]) T(other.data_[size_]);
+            }
+        }
+        return *this;
+    }
+
+    SmallArray& operator=(SmallArray&& other) noexcept {
+        if (this != &other) {
+            clear();
+            releaseHeap();
+            data_ = inlineData();
+            capacity_ = N;
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            // Аргумент может ссылаться на элемент массива — сначала копия
+            T value(std::forward<Args>(args)...);
+            reallocate(capacity_ * 2);
+            new (&data_[size_]) T(std::move(value));
+        } else {
+            new (&data_[size_]) T(std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() {
+        if (size_ > 0) {
+            --size_;
+            data_[size_].~T();
+        }
+    }
+
+    T& operator[](size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[index];
+    }
+
+    const T& operator[](size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[index];
+    }
+
+    T& back() { return (*this)[size_ - 1]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    // true, пока элементы помещаются во встроенный буфер
+    bool isSmall() const { return isInline(); }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    void clear() {
+        destroyRange(0, size_);
+        size_ = 0;
+    }
+
+    void reserve(size_t newCapacity) {
+        if (newCapacity > capacity_) {
+            reallocate(newCapacity);
+        }
+    }
+
+    void resize(size_t newSize) {
+        if (newSize <= size_) {
+            destroyRange(newSize, size_);
+            size_ = newSize;
+            return;
+        }
+        reserve(newSize);
+        for (; size_ < newSize; ++size_) {
+            new (&data_[size_]) T();
+        }
+    }
+
+    void resize(size_t newSize, const T& value) {
+        if (newSize <= size_) {
+            destroyRange(newSize, size_);
+            size_ = newSize;
+            return;
+        }
+        reserve(newSize);
+        for (; size_ < newSize; ++size_) {
+            new (&data_[size_]) T(value);
+        }
+    }
+};
@@ -0,0 +1,288 @@
+// Telemetry.hpp
+#pragma once
+#include "MinimaxAI.hpp"
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Походовая телеметрия ИИ. Каждый ход ИИ —
+// одна строка JSON Lines, дописываемая в конец файла: при падении
+// теряются только записи, не дошедшие до диска с последнего сброса.
+//
+// Набор полей статистики — тот же, что у столбцов CSV: обе выгрузки
+// строятся из columns()/values(), поэтому JSONL всегда можно свести
+// обратно к прежнему CSV (см. telemetry_to_csv.cpp).
+namespace telemetry {
+
+// Столбцы CSV статистики хода, в порядке вывода
+inline const std::vector<std::string>& columns() {
+    static const std::vector<std::string> names = {
+        "Move", "NodesVisited", "NodesGenerated", "CacheHits", "CacheMisses", "TimeMs",
+        "CacheEvictions", "TTSize", "TTCapacity", "TTTombstones", "TTLoadFactor",
+        "TTEffectiveLoadFactor", "TTBytes", "TTRehashes", "TTRehashUs",
+        "TTAvgHitProbe", "TTAvgMissProbe",
+        "ProfCheckWinUs", "ProfEvaluateUs", "ProfMoveGenUs", "ProfTTProbeUs",
+        "ProfTTStoreUs", "ProfHashUs", "NodesPerPly", "EffectiveBranching",
+        "CutoffRate", "AvgCutoffIndex",
+        "HwCycles", "HwInstructions", "HwIPC", "HwBranchMissRate",
+        "HwL1DMissRate", "HwLLCMissRate"
+    };
+    return names;
+}
+
+// Значения столбцов для одного хода (move — номер хода ИИ с 1)
+inline std::vector<std::string> values(size_t move, const AIStatistics& stats) {
+    std::vector<std::string> result;
+    result.reserve(columns().size());
+    auto add = [&result](const auto& value) {
+        std::ostringstream out;
+        out << value;
+        result.push_back(out.str());
+    };
+
+    const HashMapStats& cache = stats.cache;
+    add(move);
+    add(stats.nodesVisited);
+    add(stats.nodesGenerated);
+    add(stats.cacheHits);
+    add(stats.cacheMisses);
+    add(stats.timeMs);
+    add(stats.cacheEvictions);
+    add(cache.size);
+    add(cache.capacity);
+    add(cache.tombstones);
+    add(cache.loadFactor);
+    add(cache.effectiveLoadFactor);
+    add(cache.bytesAllocated);
+    add(cache.rehashCount);
+    add(cache.rehashTimeNs / 1000);
+    add(cache.averageHitProbe());
+    add(cache.averageMissProbe());
+
+    const SearchProfile& profile = stats.profile;
+    for (int phase = 0; phase < SearchProfile::PHASE_COUNT; ++phase) {
+        add(profile.phaseNs[phase] / 1000);
+    }
+    add(profile.nodesPerPly());
+    add(profile.effectiveBranchingFactor());
+    add(profile.cutoffRate());
+    add(profile.averageCutoffIndex());
+
+    const HardwareCounters& hw = stats.hardware;
+    add(hw.get(HardwareCounters::Cycles));
+    add(hw.get(HardwareCounters::Instructions));
+    add(hw.ipc());
+    add(hw.branchMissRate());
+    add(hw.l1dMissRate());
+    add(hw.llcMissRate());
+    return result;
+}
+
+inline void writeCsvRow(std::ostream& out, const std::vector<std::string>& row) {
+    for (size_t i = 0; i < row.size(); ++i) {
+        out << (i > 0 ? "," : "") << row[i];
+    }
+    out << "\n";
+}
+
+// Число в JSON пишется как есть, всё остальное — строкой
+inline bool isJsonNumber(const std::string& text) {
+    if (text.empty()) {
+        return false;
+    }
+    size_t start = text[0] == '-' ? 1 : 0;
+    bool digits = false;
+    for (size_t i = start; i < text.size(); ++i) {
+        char c = text[i];
+        if (c >= '0' && c <= '9') {
+            digits = true;
+        } else if (c != '.' && c != 'e' && c != 'E' && c != '-' && c != '+') {
+            return false;
+        }
+    }
+    return digits;
+}
+
+inline void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+using Record = std::vector<std::pair<std::string, std::string>>;
+
+// Разбор плоского объекта одной строки JSONL: ключ -> текст значения
+// (строки без кавычек). Вложенные объекты не поддерживаются — их и нет.
+inline bool parseLine(const std::string& line, Record& record) {
+    record.clear();
+    size_t i = 0;
+    auto skipSpaces = [&]() {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) {
+            ++i;
+        }
+    };
+    auto readString = [&](std::string& out) {
+        if (i >= line.size() || line[i] != '"') {
+            return false;
+        }
+        ++i;
+        out.clear();
+        while (i < line.size() && line[i] != '"') {
+            if (line[i] == '\\' && i + 1 < line.size()) {
+                ++i;
+            }
+            out += line[i++];
+        }
+        if (i >= line.size()) {
+            return false;
+        }
+        ++i;
+        return true;
+    };
+
+    skipSpaces();
+    if (i >= line.size() || line[i] != '{') {
+        return false;
+    }
+    ++i;
+    while (true) {
+        skipSpaces();
+        if (i < line.size() && line[i] == '}') {
+            return true;
+        }
+        std::string key;
+        if (!readString(key)) {
+            return false;
+        }
+        skipSpaces();
+        if (i >= line.size() || line[i] != ':') {
+            return false;
+        }
+        ++i;
+        skipSpaces();
+        std::string value;
+        if (i < line.size() && line[i] == '"') {
+            if (!readString(value)) {
+                return false;
+            }
+        } else {
+            while (i < line.size() && line[i] != ',' && line[i] != '}') {
+                value += line[i++];
+            }
+            while (!value.empty() && value.back() == ' ') {
+                value.pop_back();
+            }
+        }
+        record.emplace_back(key, value);
+        skipSpaces();
+        if (i < line.size() && line[i] == ',') {
+            ++i;
+        }
+    }
+}
+
+// Строка CSV из записи телеметрии: столбцы в порядке columns(),
+// отсутствующие поля (запись старой версии) — пустые
+inline std::vector<std::string> csvRow(const Record& record) {
+    std::vector<std::string> row;
+    for (const std::string& column : columns()) {
+        std::string value;
+        for (const auto& field : record) {
+            if (field.first == column) {
+                value = field.second;
+                break;
+            }
+        }
+        row.push_back(value);
+    }
+    return row;
+}
+
+// Приёмник телеметрии. Записи копятся в памяти и сбрасываются на диск
+// каждые flushEvery записей или раз в flushInterval — что наступит
+// раньше, — а также в деструкторе.
+class Sink {
+private:
+    std::ofstream file_;
+    std::string buffer_;
+    size_t pending_;
+    size_t flushEvery_;
+    std::chrono::milliseconds flushInterval_;
+    std::chrono::steady_clock::time_point lastFlush_;
+    size_t written_;
+
+public:
+    explicit Sink(const std::string& filename, size_t flushEvery = 8,
+                  std::chrono::milliseconds flushInterval = std::chrono::milliseconds(1000))
+        : file_(filename, std::ios::out | std::ios::app),
+          pending_(0),
+          flushEvery_(flushEvery == 0 ? 1 : flushEvery),
+          flushInterval_(flushInterval),
+          lastFlush_(std::chrono::steady_clock::now()),
+          written_(0) {}
+
+    ~Sink() { flush(); }
+
+    Sink(const Sink&) = delete;
+    Sink& operator=(const Sink&) = delete;
+
+    bool isOpen() const { return file_.is_open(); }
+    size_t recordsWritten() const { return written_; }
+
+    // gameId отличает партии, дописанные в один файл
+    void record(long long gameId, size_t move, char player, const Coord& cell,
+                int score, const AIStatistics& stats) {
+        long long unixMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        std::ostringstream line;
+        line << "{\"GameId\": " << gameId
+             << ", \"UnixMs\": " << unixMs
+             << ", \"Player\": \"" << player << "\""
+             << ", \"Row\": " << cell.row
+             << ", \"Col\": " << cell.col
+             << ", \"Score\": " << score;
+
+        const std::vector<std::string>& names = columns();
+        std::vector<std::string> fields = values(move, stats);
+        for (size_t i = 0; i < names.size(); ++i) {
+            line << ", \"" << names[i] << "\": ";
+            if (isJsonNumber(fields[i])) {
+                line << fields[i];
+            } else {
+                writeJsonString(line, fields[i]);
+            }
+        }
+        line << "}\n";
+
+        buffer_ += line.str();
+        ++pending_;
+        ++written_;
+
+        auto now = std::chrono::steady_clock::now();
+        if (pending_ >= flushEvery_ || now - lastFlush_ >= flushInterval_) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (!buffer_.empty() && file_.is_open()) {
+            file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            file_.flush();
+        }
+        buffer_.clear();
+        pending_ = 0;
+        lastFlush_ = std::chrono::steady_clock::now();
+    }
+};
+
+} // namespace telemetry
@@ -0,0 +1,217 @@
+// Tournament.hpp
+#pragma once
+#include "Match.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Турнир двух конфигураций движка (A и B) на самоигре. Партии идут
+// парами: одно и то же случайное начало (один seed) играется дважды
+// со сменой цвета, так что перекос начала гасится внутри пары.
+// Пары раздаются потокам через атомарный счётчик; у каждой партии свои
+// движки, так что потоки ничего не делят, кроме итогового счёта.
+namespace tournament {
+
+// Счёт с точки зрения движка A
+struct Score {
+    int wins;
+    int draws;
+    int losses;
+
+    Score() : wins(0), draws(0), losses(0) {}
+
+    int games() const { return wins + draws + losses; }
+
+    // Средние очки за партию: победа 1, ничья 1/2
+    double points() const {
+        int n = games();
+        return n > 0 ? (wins + 0.5 * draws) / n : 0.5;
+    }
+
+    // Дисперсия очков одной партии
+    double variance() const {
+        int n = games();
+        if (n == 0) {
+            return 0.0;
+        }
+        double s = points();
+        return (wins * (1.0 - s) * (1.0 - s) + draws * (0.5 - s) * (0.5 - s)
+                + losses * s * s) / n;
+    }
+};
+
+// Логистическая модель: ожидаемые очки <-> разница Эло
+inline double eloFromPoints(double points) {
+    if (points <= 0.0) {
+        return -INFINITY;
+    }
+    if (points >= 1.0) {
+        return INFINITY;
+    }
+    return -400.0 * std::log10(1.0 / points - 1.0);
+}
+
+inline double pointsFromElo(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+struct EloEstimate {
+    double elo;
+    double lower;   // 95% доверительный интервал
+    double upper;
+};
+
+inline EloEstimate estimateElo(const Score& score) {
+    EloEstimate estimate;
+    double s = score.points();
+    double margin = score.games() > 0
+        ? 1.959964 * std::sqrt(score.variance() / score.games())
+        : 0.0;
+    estimate.elo = eloFromPoints(s);
+    estimate.lower = eloFromPoints(s - margin);
+    estimate.upper = eloFromPoints(s + margin);
+    return estimate;
+}
+
+// SPRT: H0 — разница elo0, H1 — elo1; alpha/beta — ошибки I и II рода
+struct SprtConfig {
+    double elo0;
+    double elo1;
+    double alpha;
+    double beta;
+
+    SprtConfig() : elo0(0.0), elo1(10.0), alpha(0.05), beta(0.05) {}
+
+    double lowerBound() const { return std::log(beta / (1.0 - alpha)); }
+    double upperBound() const { return std::log((1.0 - beta) / alpha); }
+};
+
+// Логарифм отношения правдоподобия (нормальное приближение
+// к триномиальной модели W/D/L)
+inline double sprtLLR(const Score& score, const SprtConfig& sprt) {
+    double variance = score.variance();
+    if (score.games() == 0 || variance <= 0.0) {
+        return 0.0;
+    }
+    double s0 = pointsFromElo(sprt.elo0);
+    double s1 = pointsFromElo(sprt.elo1);
+    return score.games() * (s1 - s0) * (2.0 * score.points() - s0 - s1) / (2.0 * variance);
+}
+
+enum class SprtResult { Continue, AcceptH0, AcceptH1 };
+
+inline SprtResult sprtDecision(double llr, const SprtConfig& sprt) {
+    if (llr <= sprt.lowerBound()) {
+        return SprtResult::AcceptH0;
+    }
+    if (llr >= sprt.upperBound()) {
+        return SprtResult::AcceptH1;
+    }
+    return SprtResult::Continue;
+}
+
+struct Config {
+    MatchConfig match;      // match.x — движок A, match.o — движок B
+    int pairs;
+    uint64_t seed;
+    unsigned threads;
+    bool useSprt;
+    SprtConfig sprt;
+
+    Config() : pairs(100), seed(1), threads(1), useSprt(false) {}
+};
+
+struct PairResult {
+    int index;
+    GameResult aAsX;
+    GameResult aAsO;
+};
+
+struct Result {
+    Score score;
+    int pairsPlayed;
+    double llr;
+    SprtResult sprt;
+    double seconds;
+
+    Result() : pairsPlayed(0), llr(0.0), sprt(SprtResult::Continue), seconds(0.0) {}
+};
+
+// onPair вызывается под мьютексом итогов, по одному разу на пару,
+// в порядке завершения (не номеров) пар
+inline Result run(const Config& config,
+                  const std::function<void(const PairResult&, const Result&)>& onPair = nullptr) {
+    Result result;
+    std::mutex resultMutex;
+    std::atomic<int> next(0);
+    std::atomic<bool> stop(false);
+
+    MatchConfig swapped = config.match;
+    std::swap(swapped.x, swapped.o);
+
+    auto addGame = [&result](const GameResult& game, CellState aCell) {
+        if (game.winner == CellState::Empty) {
+            ++result.score.draws;
+        } else if (game.winner == aCell) {
+            ++result.score.wins;
+        } else {
+            ++result.score.losses;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto worker = [&]() {
+        for (int i = next.fetch_add(1); i < config.pairs && !stop.load(); i = next.fetch_add(1)) {
+            PairResult pair;
+            pair.index = i;
+            uint64_t seed = config.seed + static_cast<uint64_t>(i);
+            pair.aAsX = playGame(config.match, seed);
+            pair.aAsO = playGame(swapped, seed);
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (result.sprt != SprtResult::Continue) {
+                continue;  // решение уже принято, лишние пары не считаем
+            }
+            addGame(pair.aAsX, CellState::X);
+            addGame(pair.aAsO, CellState::O);
+            ++result.pairsPlayed;
+            if (config.useSprt) {
+                result.llr = sprtLLR(result.score, config.sprt);
+                result.sprt = sprtDecision(result.llr, config.sprt);
+                if (result.sprt != SprtResult::Continue) {
+                    stop.store(true);
+                }
+            }
+            if (onPair) {
+                onPair(pair, result);
+            }
+        }
+    };
+
+    unsigned threads = config.threads > 0 ? config.threads : 1;
+    if (threads == 1) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t) {
+            pool.emplace_back(worker);
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    if (!config.useSprt) {
+        result.llr = sprtLLR(result.score, config.sprt);
+    }
+    return result;
+}
+
+} // namespace tournament
@@ -0,0 +1,203 @@
+// Tracer.hpp
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Трассировка поиска во времени: отрезки (spans) с именем, потоком
+// и до двух числовых аргументов. Выгружается в формате Chrome Trace
+// Event JSON — открывается в chrome://tracing и ui.perfetto.dev.
+//
+// Запись идёт без блокировок: у каждого потока свой буфер, мьютекс
+// берётся только при первой записи из нового потока (регистрация
+// буфера). Выгружать трассу можно, когда пишущие потоки остановлены
+// или стоят между поисками. Пока трассировка выключена, отрезок
+// стоит одну атомарную загрузку.
+class Tracer {
+public:
+    struct Event {
+        const char* name;      // только строковые литералы
+        int64_t startNs;
+        int64_t durationNs;
+        const char* argNames[2];
+        int64_t argValues[2];
+    };
+
+private:
+    struct ThreadBuffer {
+        uint32_t tid;
+        std::vector<Event> events;
+        size_t dropped;
+    };
+
+    // Потолок на поток, чтобы забытая трассировка не съела память
+    static constexpr size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+    std::atomic<bool> enabled_;
+    std::chrono::steady_clock::time_point origin_;
+    std::mutex registryMutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    // Поколение сбрасывается в clear(): потоки перерегистрируют буферы
+    std::atomic<uint32_t> generation_;
+
+    Tracer() : enabled_(false), origin_(std::chrono::steady_clock::now()), generation_(1) {}
+
+    ThreadBuffer& localBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        thread_local uint32_t bufferGeneration = 0;
+        uint32_t generation = generation_.load(std::memory_order_acquire);
+        if (buffer == nullptr || bufferGeneration != generation) {
+            std::lock_guard<std::mutex> lock(registryMutex_);
+            buffers_.emplace_back(new ThreadBuffer());
+            buffer = buffers_.back().get();
+            buffer->tid = static_cast<uint32_t>(buffers_.size());
+            buffer->dropped = 0;
+            bufferGeneration = generation;
+        }
+        return *buffer;
+    }
+
+    static void writeEscaped(std::ostream& out, const char* text) {
+        for (const char* p = text; *p != '\0'; ++p) {
+            if (*p == '"' || *p == '\\') {
+                out << '\\';
+            }
+            out << *p;
+        }
+    }
+
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    int64_t nowNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin_).count();
+    }
+
+    void record(const Event& event) {
+        ThreadBuffer& buffer = localBuffer();
+        if (buffer.events.size() >= MAX_EVENTS_PER_THREAD) {
+            ++buffer.dropped;
+            return;
+        }
+        buffer.events.push_back(event);
+    }
+
+    size_t eventCount() {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        size_t total = 0;
+        for (const auto& buffer : buffers_) {
+            total += buffer->events.size();
+        }
+        return total;
+    }
+
+    // Все отрезки в формате Chrome Trace Event ("ph": "X", время в мкс)
+    void writeChromeTrace(std::ostream& out) {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        out << "{\"traceEvents\": [\n";
+        bool first = true;
+        size_t dropped = 0;
+        for (const auto& buffer : buffers_) {
+            dropped += buffer->dropped;
+            for (const Event& event : buffer->events) {
+                out << (first ? "  " : ",\n  ");
+                first = false;
+                out << "{\"name\": \"";
+                writeEscaped(out, event.name);
+                out << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->tid
+                    << ", \"ts\": " << event.startNs / 1000 << "." << (event.startNs % 1000) / 100
+                    << ", \"dur\": " << event.durationNs / 1000 << "."
+                    << (event.durationNs % 1000) / 100;
+                if (event.argNames[0] != nullptr) {
+                    out << ", \"args\": {";
+                    for (int i = 0; i < 2 && event.argNames[i] != nullptr; ++i) {
+                        out << (i > 0 ? ", \"" : "\"");
+                        writeEscaped(out, event.argNames[i]);
+                        out << "\": " << event.argValues[i];
+                    }
+                    out << "}";
+                }
+                out << "}";
+            }
+        }
+        out << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"droppedEvents\": "
+            << dropped << "}}\n";
+    }
+
+    bool writeChromeTrace(const std::string& filename) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            return false;
+        }
+        writeChromeTrace(file);
+        return true;
+    }
+
+    // Сбрасывает все записанные отрезки; вызывать, когда никто не пишет
+    void clear() {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        buffers_.clear();
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+};
+
+// Отрезок на время жизни объекта. Аргументы можно дописать до конца
+// отрезка через arg() — например, оценку хода после его поиска.
+class TraceSpan {
+private:
+    Tracer::Event event_;
+    bool active_;
+
+public:
+    explicit TraceSpan(const char* name) : active_(Tracer::instance().enabled()) {
+        if (active_) {
+            event_.name = name;
+            event_.argNames[0] = nullptr;
+            event_.argNames[1] = nullptr;
+            event_.argValues[0] = 0;
+            event_.argValues[1] = 0;
+            event_.startNs = Tracer::instance().nowNs();
+        }
+    }
+
+    ~TraceSpan() {
+        if (active_) {
+            event_.durationNs = Tracer::instance().nowNs() - event_.startNs;
+            Tracer::instance().record(event_);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // Не больше двух аргументов; лишние игнорируются
+    void arg(const char* name, int64_t value) {
+        if (!active_) {
+            return;
+        }
+        for (int i = 0; i < 2; ++i) {
+            if (event_.argNames[i] == nullptr || event_.argNames[i] == name) {
+                event_.argNames[i] = name;
+                event_.argValues[i] = value;
+                return;
+            }
+        }
+    }
+};
@@ -0,0 +1,88 @@
+// analyze.cpp — ЛР-3
+// Потоковый анализ позиций из файла: по строке на позицию в нотации
+// Notation.hpp ("3 3 X1O/1X1/3 O"), результат — CSV по мере разбора.
+// Память не зависит от размера входа (см. Analysis.hpp).
+//
+// Сборка: g++ -std=c++17 -O2 analyze.cpp -o analyze
+//
+// Запуск:
+//   analyze INPUT|- [OUTPUT|-] [--depth D] [--time MS] [--cache ENTRIES]
+//
+// Код возврата 1 — ошибка аргументов или файлов; битые строки входа
+// отмечаются в выходе и ошибкой не считаются.
+
+#include "Analysis.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cout << "Использование:\n"
+              << "  analyze INPUT|- [OUTPUT|-] [--depth D] [--time MS] [--cache ENTRIES]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    StreamAnalyzer::Options options;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc) {
+            options.depth = std::atoi(argv[++i]);
+        } else if (arg == "--time" && i + 1 < argc) {
+            options.timeMs = std::atoll(argv[++i]);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            options.cacheLimit = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (arg == "-" || arg[0] != '-') {
+            paths.push_back(arg);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (paths.empty() || paths.size() > 2 || options.depth < 1) {
+        printUsage();
+        return 1;
+    }
+
+    std::ifstream inFile;
+    if (paths[0] != "-") {
+        inFile.open(paths[0]);
+        if (!inFile.is_open()) {
+            std::cerr << "Не удалось открыть " << paths[0] << "\n";
+            return 1;
+        }
+    }
+    std::ofstream outFile;
+    if (paths.size() == 2 && paths[1] != "-") {
+        outFile.open(paths[1]);
+        if (!outFile.is_open()) {
+            std::cerr << "Не удалось открыть " << paths[1] << "\n";
+            return 1;
+        }
+    }
+    std::istream& in = inFile.is_open() ? static_cast<std::istream&>(inFile) : std::cin;
+    std::ostream& out = outFile.is_open() ? static_cast<std::ostream&>(outFile) : std::cout;
+
+    auto start = std::chrono::steady_clock::now();
+    StreamAnalyzer analyzer(options);
+    StreamAnalyzer::Summary summary = analyzer.run(in, out);
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    // Сводка — в stderr, чтобы не смешиваться с CSV в stdout
+    std::cerr << "Позиций: " << summary.positions
+              << " (ошибок: " << summary.errors
+              << ", законченных: " << summary.terminal << ")"
+              << ", узлов: " << summary.nodes
+              << ", " << seconds << " с\n";
+    return 0;
+}
@@ -0,0 +1,120 @@
+// bench_concurrent.cpp — ЛР-3
+// Нагрузочный тест ConcurrentHashMap: 1..64 потока, смесь поиска и вставки.
+// Для сравнения — обычный HashMap под одним глобальным мьютексом.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread bench_concurrent.cpp -o bench_concurrent
+
+#include "ConcurrentHashMap.hpp"
+#include "HashMap.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t OPS_PER_THREAD = 200000;
+const uint64_t KEY_RANGE = 1 << 16;
+const int LOOKUP_PERCENT = 80;
+
+// Простой xorshift, чтобы генерация ключей не мешала измерению
+struct XorShift {
+    uint64_t state;
+    explicit XorShift(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ULL + 1) {}
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+class GlobalLockMap {
+private:
+    std::mutex mutex_;
+    HashMap<uint64_t, uint64_t> map_;
+
+public:
+    void insert(uint64_t key, uint64_t value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        map_.insert_or_assign(key, value);
+    }
+
+    bool find(uint64_t key, uint64_t& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const uint64_t* value = map_.find(key)) {
+            out = *value;
+            return true;
+        }
+        return false;
+    }
+};
+
+template<typename Map>
+double runWorkload(Map& map, int threads) {
+    std::vector<std::thread> workers;
+    std::vector<uint64_t> sinks(static_cast<size_t>(threads), 0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&map, &sinks, t]() {
+            XorShift rng(static_cast<uint64_t>(t) + 1);
+            uint64_t found = 0;
+            for (size_t i = 0; i < OPS_PER_THREAD; ++i) {
+                uint64_t r = rng.next();
+                uint64_t key = r % KEY_RANGE;
+                if (static_cast<int>((r >> 32) % 100) < LOOKUP_PERCENT) {
+                    uint64_t value;
+                    if (map.find(key, value)) {
+                        found += value;
+                    }
+                } else {
+                    map.insert(key, r);
+                }
+            }
+            sinks[static_cast<size_t>(t)] = found;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double totalOps = static_cast<double>(OPS_PER_THREAD) * threads;
+    return totalOps / seconds / 1e6;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "ConcurrentHashMap: " << LOOKUP_PERCENT << "% поиск / "
+              << (100 - LOOKUP_PERCENT) << "% вставка, "
+              << OPS_PER_THREAD << " операций на поток, "
+              << KEY_RANGE << " ключей\n";
+    std::cout << "Аппаратных потоков: " << std::thread::hardware_concurrency() << "\n\n";
+
+    std::cout << std::setw(8) << "threads"
+              << std::setw(18) << "global Mops/s"
+              << std::setw(18) << "sharded Mops/s"
+              << std::setw(10) << "ratio" << "\n";
+
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        GlobalLockMap global;
+        ConcurrentHashMap<uint64_t, uint64_t> sharded;
+
+        double globalMops = runWorkload(global, threads);
+        double shardedMops = runWorkload(sharded, threads);
+
+        std::cout << std::setw(8) << threads
+                  << std::setw(18) << std::fixed << std::setprecision(2) << globalMops
+                  << std::setw(18) << shardedMops
+                  << std::setw(10) << shardedMops / globalMops << "\n";
+    }
+
+    return 0;
+}
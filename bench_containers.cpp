@@ -0,0 +1,416 @@
+// bench_containers.cpp — ЛР-3
+// Микробенчмарки контейнеров: DynamicArray против std::vector,
+// HashMap против std::unordered_map. Размеры 1e3..1e6, ключи —
+// последовательные, случайные и "кластерные" (кратные 4096:
+// младшие биты нулевые, плохой случай для слабого хеша).
+// Для каждой операции — нс на операцию и число выделений памяти
+// (считаются подменой глобального operator new).
+//
+// Сборка: g++ -std=c++17 -O2 bench_containers.cpp -o bench_containers
+
+#include "DynamicArray.hpp"
+#include "HashMap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// ---------- Подсчёт выделений памяти ----------
+
+namespace {
+std::atomic<size_t> g_allocations(0);
+}
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// std::pmr::new_delete_resource (а через него DynamicArray и HashMap)
+// запрашивает память с явным выравниванием — эти версии тоже считаем
+void* operator new(size_t size, std::align_val_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    size = (size + align - 1) / align * align;
+    if (size == 0) {
+        size = align;
+    }
+#ifdef _WIN32
+    void* p = _aligned_malloc(size, align);
+#else
+    void* p = std::aligned_alloc(align, size);
+#endif
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept {
+    ::operator delete(p, alignment);
+}
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept {
+    ::operator delete(p, alignment);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept {
+    ::operator delete(p, alignment);
+}
+
+namespace {
+
+const int REPEATS = 3;
+
+volatile uint64_t g_sink = 0;
+
+struct Measurement {
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+// Лучшее из REPEATS прогонов; fn возвращает число выполненных операций
+template<typename Fn>
+Measurement measure(Fn&& fn) {
+    Measurement best = {1e300, 0.0};
+    for (int r = 0; r < REPEATS; ++r) {
+        size_t allocsBefore = g_allocations.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        size_t ops = fn();
+        auto end = std::chrono::steady_clock::now();
+        size_t allocs = g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        double perOp = ns / static_cast<double>(ops);
+        if (perOp < best.nsPerOp) {
+            best.nsPerOp = perOp;
+            best.allocsPerOp = static_cast<double>(allocs) / static_cast<double>(ops);
+        }
+    }
+    return best;
+}
+
+void printRow(const std::string& name, size_t n, const Measurement& ours,
+              const Measurement& stdlib) {
+    std::cout << std::left << std::setw(28) << name << std::right
+              << std::setw(9) << n
+              << std::fixed << std::setprecision(2)
+              << std::setw(11) << ours.nsPerOp
+              << std::setw(11) << stdlib.nsPerOp
+              << std::setw(8) << stdlib.nsPerOp / ours.nsPerOp
+              << std::setprecision(4)
+              << std::setw(12) << ours.allocsPerOp
+              << std::setw(12) << stdlib.allocsPerOp << "\n";
+}
+
+void printHeader(const char* title) {
+    std::cout << "\n" << title << "\n"
+              << std::left << std::setw(28) << "benchmark" << std::right
+              << std::setw(9) << "n"
+              << std::setw(11) << "ours ns"
+              << std::setw(11) << "std ns"
+              << std::setw(8) << "x"
+              << std::setw(12) << "ours alloc"
+              << std::setw(12) << "std alloc" << "\n";
+}
+
+uint64_t splitmix(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+enum class KeyKind { Sequential, Random, Clustered };
+
+const char* keyKindName(KeyKind kind) {
+    switch (kind) {
+        case KeyKind::Sequential: return "seq";
+        case KeyKind::Random: return "rand";
+        case KeyKind::Clustered: return "clust";
+    }
+    return "?";
+}
+
+std::vector<uint64_t> makeKeys(KeyKind kind, size_t n, uint64_t seed) {
+    std::vector<uint64_t> keys(n);
+    uint64_t state = seed;
+    for (size_t i = 0; i < n; ++i) {
+        switch (kind) {
+            case KeyKind::Sequential: keys[i] = i; break;
+            case KeyKind::Random: keys[i] = splitmix(state); break;
+            case KeyKind::Clustered: keys[i] = static_cast<uint64_t>(i) * 4096; break;
+        }
+    }
+    return keys;
+}
+
+// Ключи, которых заведомо нет среди makeKeys(kind, n, ...)
+std::vector<uint64_t> makeMissingKeys(KeyKind kind, size_t n) {
+    std::vector<uint64_t> keys = makeKeys(kind, n, 0x5EED);
+    for (uint64_t& key : keys) {
+        key = kind == KeyKind::Random ? key | 1 : key + n * 4096 + 1;
+    }
+    return keys;
+}
+
+// ---------- DynamicArray против std::vector ----------
+
+template<typename Array>
+size_t pushBack(size_t n) {
+    Array arr;
+    for (size_t i = 0; i < n; ++i) {
+        arr.push_back(static_cast<uint64_t>(i));
+    }
+    g_sink += arr[n / 2];
+    return n;
+}
+
+template<typename Array>
+size_t randomAccess(const Array& arr, const std::vector<uint32_t>& indices) {
+    uint64_t sum = 0;
+    for (uint32_t index : indices) {
+        sum += arr[index];
+    }
+    g_sink += sum;
+    return indices.size();
+}
+
+template<typename Array>
+size_t iterate(const Array& arr) {
+    uint64_t sum = 0;
+    for (uint64_t value : arr) {
+        sum += value;
+    }
+    g_sink += sum;
+    return arr.size();
+}
+
+void benchArrays(size_t n) {
+    DynamicArray<uint64_t> ours;
+    std::vector<uint64_t> theirs;
+    for (size_t i = 0; i < n; ++i) {
+        ours.push_back(i);
+        theirs.push_back(i);
+    }
+    std::vector<uint32_t> indices(n);
+    uint64_t state = 42;
+    for (uint32_t& index : indices) {
+        index = static_cast<uint32_t>(splitmix(state) % n);
+    }
+
+    printRow("push_back (no reserve)", n,
+             measure([n]() { return pushBack<DynamicArray<uint64_t>>(n); }),
+             measure([n]() { return pushBack<std::vector<uint64_t>>(n); }));
+    printRow("random access", n,
+             measure([&]() { return randomAccess(ours, indices); }),
+             measure([&]() { return randomAccess(theirs, indices); }));
+    printRow("iterate", n,
+             measure([&]() { return iterate(ours); }),
+             measure([&]() { return iterate(theirs); }));
+}
+
+// ---------- HashMap против std::unordered_map ----------
+// Обёртки сводят оба интерфейса к одному набору операций
+
+struct OurMap {
+    HashMap<uint64_t, uint64_t> map;
+    void insert(uint64_t k, uint64_t v) { map.insert_or_assign(k, v); }
+    bool find(uint64_t k, uint64_t& out) {
+        if (const uint64_t* v = map.find(k)) {
+            out = *v;
+            return true;
+        }
+        return false;
+    }
+    void erase(uint64_t k) { map.remove(k); }
+};
+
+struct StdMap {
+    std::unordered_map<uint64_t, uint64_t> map;
+    void insert(uint64_t k, uint64_t v) { map[k] = v; }
+    bool find(uint64_t k, uint64_t& out) {
+        auto it = map.find(k);
+        if (it == map.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+    void erase(uint64_t k) { map.erase(k); }
+};
+
+template<typename Map>
+size_t insertAll(const std::vector<uint64_t>& keys) {
+    Map m;
+    for (uint64_t key : keys) {
+        m.insert(key, key);
+    }
+    g_sink += m.map.size();
+    return keys.size();
+}
+
+template<typename Map>
+size_t lookupAll(Map& m, const std::vector<uint64_t>& keys) {
+    uint64_t sum = 0;
+    for (uint64_t key : keys) {
+        uint64_t value;
+        if (m.find(key, value)) {
+            sum += value + 1;
+        }
+    }
+    g_sink += sum;
+    return keys.size();
+}
+
+// 50% поиск, 25% вставка, 25% удаление по ключам из пула 2n
+template<typename Map>
+size_t mixed(const std::vector<uint64_t>& pool, size_t ops) {
+    Map m;
+    for (size_t i = 0; i < pool.size() / 2; ++i) {
+        m.insert(pool[i], i);
+    }
+    uint64_t state = 7;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < ops; ++i) {
+        uint64_t r = splitmix(state);
+        uint64_t key = pool[r % pool.size()];
+        unsigned op = static_cast<unsigned>(r >> 62);
+        if (op < 2) {
+            uint64_t value;
+            if (m.find(key, value)) {
+                sum += value;
+            }
+        } else if (op == 2) {
+            m.insert(key, i);
+        } else {
+            m.erase(key);
+        }
+    }
+    g_sink += sum;
+    return ops;
+}
+
+// Размер постоянный, но ключи всё время меняются: каждый шаг удаляет
+// самый старый ключ и вставляет новый. У открытой адресации это копит
+// надгробия; у std::unordered_map — выделение на каждую вставку.
+template<typename Map>
+size_t churn(const std::vector<uint64_t>& keys, size_t live) {
+    Map m;
+    for (size_t i = 0; i < live; ++i) {
+        m.insert(keys[i], i);
+    }
+    for (size_t i = live; i < keys.size(); ++i) {
+        m.erase(keys[i - live]);
+        m.insert(keys[i], i);
+    }
+    uint64_t value;
+    g_sink += m.find(keys.back(), value) ? value : 0;
+    return keys.size() - live;
+}
+
+void benchMaps(size_t n, KeyKind kind) {
+    std::vector<uint64_t> keys = makeKeys(kind, n, 1);
+    std::vector<uint64_t> missing = makeMissingKeys(kind, n);
+    std::string suffix = std::string(" [") + keyKindName(kind) + "]";
+
+    OurMap ours;
+    StdMap theirs;
+    for (uint64_t key : keys) {
+        ours.insert(key, key);
+        theirs.insert(key, key);
+    }
+
+    printRow("insert" + suffix, n,
+             measure([&]() { return insertAll<OurMap>(keys); }),
+             measure([&]() { return insertAll<StdMap>(keys); }));
+    printRow("find hit" + suffix, n,
+             measure([&]() { return lookupAll(ours, keys); }),
+             measure([&]() { return lookupAll(theirs, keys); }));
+    printRow("find miss" + suffix, n,
+             measure([&]() { return lookupAll(ours, missing); }),
+             measure([&]() { return lookupAll(theirs, missing); }));
+
+    std::vector<uint64_t> pool = makeKeys(kind, 2 * n, 2);
+    printRow("mix 50/25/25" + suffix, n,
+             measure([&]() { return mixed<OurMap>(pool, 2 * n); }),
+             measure([&]() { return mixed<StdMap>(pool, 2 * n); }));
+
+    std::vector<uint64_t> stream = makeKeys(kind, 5 * n, 3);
+    printRow("churn (tombstones)" + suffix, n,
+             measure([&]() { return churn<OurMap>(stream, n); }),
+             measure([&]() { return churn<StdMap>(stream, n); }));
+}
+
+} // namespace
+
+int main() {
+    const size_t sizes[] = {1000, 100000, 1000000};
+
+    std::cout << "Микробенчмарки контейнеров (лучшее из " << REPEATS << " прогонов)\n";
+    std::cout << "x — во сколько раз std медленнее (>1 — наш контейнер быстрее)\n";
+
+    printHeader("DynamicArray<uint64_t> против std::vector<uint64_t>");
+    for (size_t n : sizes) {
+        benchArrays(n);
+    }
+
+    printHeader("HashMap<uint64_t, uint64_t> против std::unordered_map");
+    for (size_t n : sizes) {
+        for (KeyKind kind : {KeyKind::Sequential, KeyKind::Random, KeyKind::Clustered}) {
+            benchMaps(n, kind);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+// bench_rehash.cpp — ЛР-3
+// Задержка отдельных вставок в HashMap: обычный рехеш (всё сразу)
+// против инкрементального (по несколько групп на операцию).
+//
+// Сборка: g++ -std=c++17 -O2 bench_rehash.cpp -o bench_rehash
+
+#include "HashMap.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const size_t INSERTS = 4000000;
+
+struct LatencyReport {
+    double p50;
+    double p99;
+    double p999;
+    double max;
+    double totalMs;
+};
+
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+LatencyReport measureInserts(bool incremental) {
+    HashMap<uint64_t, uint64_t> map;
+    map.setIncrementalRehash(incremental);
+
+    std::vector<double> latencies;
+    latencies.reserve(INSERTS);
+
+    uint64_t key = 0x9E3779B97F4A7C15ULL;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < INSERTS; ++i) {
+        key = key * 6364136223846793005ULL + 1442695040888963407ULL;
+
+        auto before = std::chrono::steady_clock::now();
+        map.insert(key, i);
+        auto after = std::chrono::steady_clock::now();
+
+        latencies.push_back(std::chrono::duration<double, std::nano>(after - before).count());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::sort(latencies.begin(), latencies.end());
+    LatencyReport report;
+    report.p50 = percentile(latencies, 0.50);
+    report.p99 = percentile(latencies, 0.99);
+    report.p999 = percentile(latencies, 0.999);
+    report.max = latencies.back();
+    report.totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+    return report;
+}
+
+void printRow(const char* name, const LatencyReport& r) {
+    std::cout << std::setw(14) << name
+              << std::fixed << std::setprecision(0)
+              << std::setw(10) << r.p50
+              << std::setw(10) << r.p99
+              << std::setw(10) << r.p999
+              << std::setw(14) << r.max
+              << std::setprecision(1)
+              << std::setw(12) << r.totalMs << "\n";
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Вставка " << INSERTS << " случайных ключей в HashMap<uint64_t, uint64_t>\n";
+    std::cout << "Задержка одной вставки, нс (в общем времени учтён и замер часов)\n\n";
+
+    std::cout << std::setw(14) << "mode"
+              << std::setw(10) << "p50"
+              << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9"
+              << std::setw(14) << "max"
+              << std::setw(12) << "total ms" << "\n";
+
+    printRow("stop-the-world", measureInserts(false));
+    printRow("incremental", measureInserts(true));
+
+    return 0;
+}
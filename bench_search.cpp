@@ -0,0 +1,421 @@
+// bench_search.cpp — ЛР-3
+// Воспроизводимый бенчмарк поиска: фиксированный набор позиций
+// (поля 3x3..10x10, разные длины линии, глубины и настройки ИИ, плюс
+// режим большой доски на 10x10, 15x15 и 19x19), каждая позиция
+// прогоняется несколько раз, берётся медиана времени. Для большой доски
+// печатается и отношение nps 19x19 к 10x10 — стоимость узла не должна
+// расти с полем.
+// Результат — JSON и/или CSV; режим сравнения ищет регрессии
+// относительно сохранённого базового JSON.
+//
+// Сборка: g++ -std=c++17 -O2 bench_search.cpp -o bench_search
+//
+// Запуск:
+//   bench_search [--repeat N] [--json FILE] [--csv FILE]
+//                [--compare BASELINE.json] [--threshold 0.10] [--filter STR]
+//
+// Код возврата 1 — найдена регрессия (или ошибка аргументов).
+
+#include "MinimaxAI.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct BenchCase {
+    std::string name;
+    int size;
+    int winLength;
+    int depth;
+    bool memoization;
+    bool persistentCache;
+    // Ходы до начала поиска, по очереди X, O, X, ...
+    std::vector<Coord> setup;
+    // MinimaxAI::setLargeBoardMode(): ходы рядом с фишками, образцы
+    bool largeBoard = false;
+};
+
+struct BenchResult {
+    std::string name;
+    int size;
+    int winLength;
+    int depth;
+    bool memoization;
+    size_t nodes;
+    double medianMs;
+    double minMs;
+    double nps;
+    double ttHitRate;
+    long peakRssKb;
+    Coord move;
+    int score;
+};
+
+// Пиковый RSS процесса в КБ. Величина монотонна: для каждого случая
+// это максимум по всем прогонам до него включительно.
+long peakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<long>(usage.ru_maxrss / 1024); // на macOS — в байтах
+#else
+    return static_cast<long>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// Позиции подобраны так, чтобы весь набор шёл секунды, а не минуты.
+// Пустые поля не годятся: для них ИИ сразу ходит в центр.
+std::vector<BenchCase> makeCorpus() {
+    std::vector<BenchCase> corpus;
+
+    std::vector<Coord> opening3 = {Coord(0, 0)};
+    corpus.push_back({"3x3-w3-d9-memo", 3, 3, 9, true, true, opening3});
+    corpus.push_back({"3x3-w3-d9-nomemo", 3, 3, 9, false, true, opening3});
+    corpus.push_back({"3x3-w3-d9-arena", 3, 3, 9, true, false, opening3});
+
+    std::vector<Coord> opening4 = {Coord(1, 1), Coord(2, 2)};
+    corpus.push_back({"4x4-w3-d6-memo", 4, 3, 6, true, true, opening4});
+    corpus.push_back({"4x4-w4-d6-memo", 4, 4, 6, true, true, opening4});
+    corpus.push_back({"4x4-w4-d6-nomemo", 4, 4, 6, false, true, opening4});
+
+    std::vector<Coord> opening5 = {Coord(2, 2), Coord(1, 1), Coord(2, 3), Coord(2, 1)};
+    corpus.push_back({"5x5-w4-d4-memo", 5, 4, 4, true, true, opening5});
+    corpus.push_back({"5x5-w4-d4-arena", 5, 4, 4, true, false, opening5});
+
+    std::vector<Coord> opening7 = {Coord(3, 3), Coord(2, 2), Coord(3, 4)};
+    corpus.push_back({"7x7-w5-d3-memo", 7, 5, 3, true, true, opening7});
+    corpus.push_back({"7x7-w5-d3-nomemo", 7, 5, 3, false, true, opening7});
+
+    std::vector<Coord> opening10 = {Coord(5, 5), Coord(4, 4), Coord(5, 6), Coord(4, 6)};
+    corpus.push_back({"10x10-w5-d2-memo", 10, 5, 2, true, true, opening10});
+    corpus.push_back({"10x10-w5-d3-memo", 10, 5, 3, true, true, opening10});
+
+    // Одна и та же позиция у центра на полях разного размера
+    for (int size : {10, 15, 19}) {
+        int c = size / 2;
+        std::vector<Coord> opening = {Coord(c, c), Coord(c - 1, c - 1), Coord(c, c + 1),
+                                      Coord(c - 1, c + 1), Coord(c + 1, c - 1)};
+        std::string name = std::to_string(size) + "x" + std::to_string(size) + "-w5-d5-large";
+        corpus.push_back({name, size, 5, 5, true, true, opening, true});
+    }
+
+    return corpus;
+}
+
+Board setupBoard(const BenchCase& bench) {
+    Board board(bench.size, bench.winLength);
+    for (size_t i = 0; i < bench.setup.size(); ++i) {
+        board.set(bench.setup[i], i % 2 == 0 ? CellState::X : CellState::O);
+    }
+    return board;
+}
+
+Player sideToMove(const BenchCase& bench) {
+    return bench.setup.size() % 2 == 0 ? Player::X : Player::O;
+}
+
+BenchResult runCase(const BenchCase& bench, int repeat) {
+    std::vector<double> times;
+    BenchResult result;
+    result.name = bench.name;
+    result.size = bench.size;
+    result.winLength = bench.winLength;
+    result.depth = bench.depth;
+    result.memoization = bench.memoization;
+
+    for (int r = 0; r < repeat; ++r) {
+        // Новый ИИ на каждый прогон: кеш не переживает повтор
+        Board board = setupBoard(bench);
+        MinimaxAI ai(sideToMove(bench), bench.depth, bench.memoization);
+        ai.setPersistentCache(bench.persistentCache);
+        if (bench.largeBoard) {
+            ai.setLargeBoardMode();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        MoveEvaluation eval = ai.findBestMove(board);
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+        const AIStatistics& stats = ai.getStatistics();
+        result.nodes = stats.nodesVisited;
+        result.move = eval.move;
+        result.score = eval.score;
+        size_t lookups = stats.cacheHits + stats.cacheMisses;
+        result.ttHitRate = lookups > 0
+            ? static_cast<double>(stats.cacheHits) / static_cast<double>(lookups)
+            : 0.0;
+    }
+
+    std::sort(times.begin(), times.end());
+    result.medianMs = times[times.size() / 2];
+    result.minMs = times.front();
+    result.nps = result.medianMs > 0.0
+        ? static_cast<double>(result.nodes) / (result.medianMs / 1000.0)
+        : 0.0;
+    result.peakRssKb = peakRssKb();
+    return result;
+}
+
+// По одной записи на строку — так базовый файл читается без JSON-библиотеки
+void writeJson(std::ostream& out, const std::vector<BenchResult>& results, int repeat) {
+    out << "{\n  \"repeat\": " << repeat << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\""
+            << ", \"size\": " << r.size
+            << ", \"winLength\": " << r.winLength
+            << ", \"depth\": " << r.depth
+            << ", \"memoization\": " << (r.memoization ? "true" : "false")
+            << ", \"nodes\": " << r.nodes
+            << std::fixed << std::setprecision(3)
+            << ", \"medianMs\": " << r.medianMs
+            << ", \"minMs\": " << r.minMs
+            << std::setprecision(0)
+            << ", \"nps\": " << r.nps
+            << std::setprecision(4)
+            << ", \"ttHitRate\": " << r.ttHitRate
+            << ", \"peakRssKb\": " << r.peakRssKb
+            << ", \"moveRow\": " << r.move.row
+            << ", \"moveCol\": " << r.move.col
+            << ", \"score\": " << r.score << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void writeCsv(std::ostream& out, const std::vector<BenchResult>& results) {
+    out << "Name,Size,WinLength,Depth,Memoization,Nodes,MedianMs,MinMs,Nps,"
+           "TTHitRate,PeakRssKb,MoveRow,MoveCol,Score\n";
+    for (const BenchResult& r : results) {
+        out << r.name << "," << r.size << "," << r.winLength << "," << r.depth << ","
+            << (r.memoization ? 1 : 0) << "," << r.nodes << ","
+            << std::fixed << std::setprecision(3) << r.medianMs << "," << r.minMs << ","
+            << std::setprecision(0) << r.nps << ","
+            << std::setprecision(4) << r.ttHitRate << ","
+            << r.peakRssKb << "," << r.move.row << "," << r.move.col << ","
+            << r.score << "\n";
+    }
+}
+
+// Значение поля "key": число из строки записи
+bool jsonNumber(const std::string& line, const std::string& key, double& out) {
+    std::string pattern = "\"" + key + "\": ";
+    size_t pos = line.find(pattern);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    out = std::strtod(line.c_str() + pos + pattern.size(), nullptr);
+    return true;
+}
+
+bool jsonString(const std::string& line, const std::string& key, std::string& out) {
+    std::string pattern = "\"" + key + "\": \"";
+    size_t pos = line.find(pattern);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    size_t start = pos + pattern.size();
+    size_t end = line.find('"', start);
+    if (end == std::string::npos) {
+        return false;
+    }
+    out = line.substr(start, end - start);
+    return true;
+}
+
+struct BaselineEntry {
+    std::string name;
+    double nodes;
+    double medianMs;
+    double score;
+};
+
+bool readBaseline(const std::string& path, std::vector<BaselineEntry>& entries) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        BaselineEntry entry;
+        if (jsonString(line, "name", entry.name)
+            && jsonNumber(line, "nodes", entry.nodes)
+            && jsonNumber(line, "medianMs", entry.medianMs)
+            && jsonNumber(line, "score", entry.score)) {
+            entries.push_back(entry);
+        }
+    }
+    return true;
+}
+
+// Регрессия — рост медианы времени больше порога. Число узлов
+// и оценка детерминированы: любое их изменение — смена поведения поиска.
+int compareWithBaseline(const std::vector<BenchResult>& results,
+                        const std::vector<BaselineEntry>& baseline,
+                        double threshold) {
+    int regressions = 0;
+    std::cout << "\nСравнение с базой (порог " << threshold * 100.0 << "%):\n";
+    std::cout << std::left << std::setw(22) << "case" << std::right
+              << std::setw(12) << "base ms" << std::setw(12) << "now ms"
+              << std::setw(10) << "delta" << "  status\n";
+
+    for (const BenchResult& r : results) {
+        const BaselineEntry* base = nullptr;
+        for (const BaselineEntry& entry : baseline) {
+            if (entry.name == r.name) {
+                base = &entry;
+                break;
+            }
+        }
+        if (base == nullptr) {
+            std::cout << std::left << std::setw(22) << r.name << std::right
+                      << "  нет в базе\n";
+            continue;
+        }
+
+        double delta = base->medianMs > 0.0 ? r.medianMs / base->medianMs - 1.0 : 0.0;
+        const char* status = "ok";
+        if (static_cast<double>(r.nodes) != base->nodes
+            || static_cast<double>(r.score) != base->score) {
+            status = "CHANGED (nodes/score)";
+            ++regressions;
+        } else if (delta > threshold) {
+            status = "REGRESSION";
+            ++regressions;
+        } else if (delta < -threshold) {
+            status = "faster";
+        }
+
+        std::cout << std::left << std::setw(22) << r.name << std::right
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(12) << base->medianMs
+                  << std::setw(12) << r.medianMs
+                  << std::setw(9) << delta * 100.0 << "%"
+                  << "  " << status << "\n";
+    }
+    return regressions;
+}
+
+void printUsage() {
+    std::cout << "Использование: bench_search [--repeat N] [--json FILE] [--csv FILE]\n"
+              << "                    [--compare BASELINE.json] [--threshold 0.10]"
+              << " [--filter STR]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int repeat = 5;
+    double threshold = 0.10;
+    std::string jsonPath;
+    std::string csvPath;
+    std::string baselinePath;
+    std::string filter;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--repeat" && hasValue) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else if (arg == "--csv" && hasValue) {
+            csvPath = argv[++i];
+        } else if (arg == "--compare" && hasValue) {
+            baselinePath = argv[++i];
+        } else if (arg == "--threshold" && hasValue) {
+            threshold = std::atof(argv[++i]);
+        } else if (arg == "--filter" && hasValue) {
+            filter = argv[++i];
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    std::cout << std::left << std::setw(22) << "case" << std::right
+              << std::setw(12) << "nodes" << std::setw(12) << "median ms"
+              << std::setw(14) << "nps" << std::setw(8) << "TT hit"
+              << std::setw(12) << "RSS KB" << "\n";
+
+    for (const BenchCase& bench : makeCorpus()) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        BenchResult r = runCase(bench, repeat);
+        results.push_back(r);
+        std::cout << std::left << std::setw(22) << r.name << std::right
+                  << std::setw(12) << r.nodes
+                  << std::fixed << std::setprecision(2) << std::setw(12) << r.medianMs
+                  << std::setprecision(0) << std::setw(14) << r.nps
+                  << std::setprecision(2) << std::setw(8) << r.ttHitRate
+                  << std::setw(12) << r.peakRssKb << "\n";
+    }
+
+    const BenchResult* small = nullptr;
+    const BenchResult* large = nullptr;
+    for (const BenchResult& r : results) {
+        if (r.name == "10x10-w5-d5-large") {
+            small = &r;
+        } else if (r.name == "19x19-w5-d5-large") {
+            large = &r;
+        }
+    }
+    if (small != nullptr && large != nullptr && small->nps > 0.0) {
+        std::cout << "Большая доска: nps 19x19 / 10x10 = " << std::setprecision(2)
+                  << large->nps / small->nps << "\n";
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        writeJson(out, results, repeat);
+        std::cout << "JSON: " << jsonPath << "\n";
+    }
+    if (!csvPath.empty()) {
+        std::ofstream out(csvPath);
+        writeCsv(out, results);
+        std::cout << "CSV: " << csvPath << "\n";
+    }
+
+    if (!baselinePath.empty()) {
+        std::vector<BaselineEntry> baseline;
+        if (!readBaseline(baselinePath, baseline)) {
+            std::cerr << "Не удалось открыть базу: " << baselinePath << "\n";
+            return 1;
+        }
+        int regressions = compareWithBaseline(results, baseline, threshold);
+        if (regressions > 0) {
+            std::cout << "Регрессий: " << regressions << "\n";
+            return 1;
+        }
+        std::cout << "Регрессий нет\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+// game_records.cpp — ЛР-3
+// Разбор двоичного архива партий (GameRecord.hpp): итоги, длина партий,
+// дебютная книга по первым ходам, проверка повтором на доске.
+// Архив отображается в память и читается одним проходом.
+//
+// Сборка: g++ -std=c++17 -O2 game_records.cpp -o game_records
+//
+// Запуск:
+//   game_records ARCHIVE [--verify] [--book PLIES] [--dump N]
+//
+// Код возврата 1 — архив не открылся, оборван или (с --verify)
+// какая-то партия не воспроизводится.
+
+#include "Board.hpp"
+#include "CompactBoard.hpp"
+#include "GameRecord.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BookEntry {
+    size_t games = 0;
+    size_t xWins = 0;
+    size_t oWins = 0;
+};
+
+void printUsage() {
+    std::cout << "Использование:\n"
+              << "  game_records ARCHIVE [--verify] [--book PLIES] [--dump N]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    bool verify = false;
+    int bookPlies = 0;
+    size_t dump = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verify") {
+            verify = true;
+        } else if (arg == "--book" && i + 1 < argc) {
+            bookPlies = std::atoi(argv[++i]);
+        } else if (arg == "--dump" && i + 1 < argc) {
+            dump = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (!arg.empty() && arg[0] != '-' && path.empty()) {
+            path = arg;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (path.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    records::Archive archive;
+    if (!archive.open(path)) {
+        std::cout << archive.error() << "\n";
+        return 1;
+    }
+
+    size_t results[4] = {0, 0, 0, 0};
+    size_t totalMoves = 0;
+    size_t bad = 0;
+    std::map<std::string, size_t> bySize;
+    // Ключ книги — поле и первые ходы ("3x3/3: 4 0 8")
+    std::map<std::string, BookEntry> book;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t count = archive.forEach([&](const records::RecordView& game) {
+        ++results[static_cast<int>(game.result) & 3];
+        totalMoves += game.moveCount;
+
+        std::string board = std::to_string(game.size) + "x" + std::to_string(game.size)
+                          + "/" + std::to_string(game.winLength);
+        ++bySize[board];
+
+        if (bookPlies > 0 && game.moveCount >= bookPlies) {
+            std::string key = board + ":";
+            for (int i = 0; i < bookPlies; ++i) {
+                key += " " + std::to_string(game.moves[i]);
+            }
+            BookEntry& entry = book[key];
+            ++entry.games;
+            entry.xWins += game.result == records::Result::XWins;
+            entry.oWins += game.result == records::Result::OWins;
+        }
+
+        if (verify) {
+            bool ok = game.size <= CompactBoard::MAX_SIZE && game.winLength <= game.size;
+            if (ok) {
+                CompactBoard replayBoard(game.size, game.winLength);
+                ok = records::replay(game, replayBoard);
+            }
+            bad += !ok;
+        }
+
+        if (dump > 0) {
+            --dump;
+            std::cout << board << " " << records::resultName(game.result) << ":";
+            for (size_t i = 0; i < game.moveCount; ++i) {
+                Coord move = game.move(i);
+                std::cout << " " << move.row << "," << move.col;
+                if (game.hasScores()) {
+                    std::cout << "(" << game.score(i) << ")";
+                }
+            }
+            std::cout << "\n";
+        }
+    });
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Партий: " << count
+              << " (X: " << results[1] << ", O: " << results[2]
+              << ", ничьи: " << results[0] << ", не доиграны: " << results[3] << ")\n";
+    if (count > 0) {
+        std::cout << "Средняя длина: " << std::fixed << std::setprecision(2)
+                  << static_cast<double>(totalMoves) / count << " ходов\n";
+    }
+    for (const auto& size : bySize) {
+        std::cout << "  " << size.first << ": " << size.second << "\n";
+    }
+
+    if (!book.empty()) {
+        std::vector<std::pair<std::string, BookEntry>> lines(book.begin(), book.end());
+        std::sort(lines.begin(), lines.end(), [](const auto& a, const auto& b) {
+            return a.second.games > b.second.games;
+        });
+        std::cout << "Книга (" << bookPlies << " ход., клетки row*size+col):\n";
+        for (size_t i = 0; i < lines.size() && i < 20; ++i) {
+            const BookEntry& entry = lines[i].second;
+            std::cout << "  " << lines[i].first << " — " << entry.games << " партий, X "
+                      << std::setprecision(1) << 100.0 * entry.xWins / entry.games << "%, O "
+                      << 100.0 * entry.oWins / entry.games << "%\n";
+        }
+    }
+
+    double mb = archive.bytes() / (1024.0 * 1024.0);
+    std::cout << std::setprecision(2) << "Прочитано " << mb << " МБ за "
+              << seconds * 1000.0 << " мс";
+    if (seconds > 0.0) {
+        std::cout << " (" << std::setprecision(0) << mb / seconds << " МБ/с, "
+                  << count / seconds << " партий/с)";
+    }
+    std::cout << "\n";
+
+    if (archive.truncated()) {
+        std::cout << "Архив оборван: последняя запись неполная\n";
+    }
+    if (verify) {
+        std::cout << (bad == 0 ? "Все партии воспроизводятся\n"
+                               : "Не воспроизводится партий: " + std::to_string(bad) + "\n");
+    }
+    return archive.truncated() || bad > 0 ? 1 : 0;
+}
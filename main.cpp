@@ -1,14 +1,31 @@
 // main.cpp — ЛР-3, "Крестики-нолики с ИИ (минимакс)"
 #include "Board.hpp"
+#include "EngineProtocol.hpp"
+#include "GameRecord.hpp"
+#include "Match.hpp"
 #include "MinimaxAI.hpp"
+#include "Renderer.hpp"
+#include "Telemetry.hpp"
+#include "Tracer.hpp"
 
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <limits>
+#include <memory>
 #include <random>
 #include <thread>
 #include <chrono>
+#include <vector>
+
+// Потолок транспозиционной таблицы каждого ИИ: долгие партии ИИ vs ИИ
+// не должны бесконечно наращивать память (не больше ~40 МБ на ИИ)
+const size_t AI_CACHE_LIMIT = 1 << 19;
+
+// Куда Game::play выгружает трассировку поиска (если она включена)
+const char* TRACE_FILE = "game_trace.json";
 
 class Game {
 private:
@@ -23,6 +40,15 @@ private:
     int  openingRandomMovesDone_;   // сколько случайных начальных ходов уже сделано
     int  openingRandomMovesLimit_;  // максимум случайных ходов в начале партии
     std::mt19937 rng_;              // генератор случайных чисел для ИИ vs ИИ
+    std::string traceFile_;         // пусто — трассировка выключена
+    telemetry::Sink* telemetry_;    // nullptr — телеметрия выключена
+    long long gameId_;              // метка партии в телеметрии
+    size_t aiMovesMade_;            // номер хода ИИ для телеметрии
+    records::Writer* records_;      // nullptr — партия в архив не пишется
+    records::GameRecord record_;    // ходы текущей партии
+    int lastScore_;                 // оценка последнего хода ИИ (0 — случайный)
+    int renderEvery_;               // ИИ vs ИИ, быстро: рисовать каждый N-й ход
+    std::vector<std::string> status_;  // строки под полем в режиме показа
 
     void clearScreen() {
     #ifdef _WIN32
@@ -89,7 +115,7 @@ private:
 
         // 1) Немного случайности только в начале партии (для разнообразия)
         if (demoMode && openingRandomMovesDone_ < openingRandomMovesLimit_) {
-            DynamicArray<Coord> emptyCells = board_.getEmptyCells();
+            MoveList emptyCells = board_.getEmptyCells();
             if (!emptyCells.empty()) {
                 std::uniform_int_distribution<int> idxDist(
                     0, static_cast<int>(emptyCells.size()) - 1
@@ -98,33 +124,70 @@ private:
                 move = emptyCells[static_cast<std::size_t>(idx)];
 
                 ++openingRandomMovesDone_;
+                lastScore_ = 0;
 
-                std::cout << "Случайный начальный ход ИИ: ("
-                          << move.row << ", " << move.col << ")\n";
-
-                applyAIPause(demoMode);
+                std::string text = "Случайный начальный ход ИИ: ("
+                                 + std::to_string(move.row) + ", "
+                                 + std::to_string(move.col) + ")";
+                status_.assign(1, text);
                 return move;
             }
         }
 
         // 2) Обычный minimax для всех остальных ходов
-        std::cout << "ИИ думает...\n";
+        if (!demoMode) {
+            std::cout << "ИИ думает...\n";
+        }
         MinimaxAI& ai =
             (currentPlayer == Player::X) ? aiX_ : aiO_;
         MoveEvaluation eval = ai.findBestMove(board_);
         move = eval.move;
+        lastScore_ = eval.score;
+
+        if (demoMode) {
+            // В режиме показа — пара строк под полем вместо полной
+            // статистики: их перерисовывает TerminalRenderer
+            const AIStatistics& stats = ai.getStatistics();
+            status_.assign(1, "ИИ выбрал ход: (" + std::to_string(move.row) + ", "
+                              + std::to_string(move.col) + "), оценка "
+                              + std::to_string(eval.score));
+            status_.push_back("Узлов: " + std::to_string(stats.nodesVisited)
+                              + ", кеш: " + std::to_string(stats.cacheHits) + "/"
+                              + std::to_string(stats.cacheMisses)
+                              + ", время: " + std::to_string(stats.timeMs) + " мс");
+        } else {
+            std::cout << "ИИ выбрал ход: (" << move.row << ", "
+                      << move.col << ")\n";
+            std::cout << "Оценка позиции: " << eval.score << "\n\n";
 
-        std::cout << "ИИ выбрал ход: (" << move.row << ", "
-                  << move.col << ")\n";
-        std::cout << "Оценка позиции: " << eval.score << "\n\n";
-
-        ai.getStatistics().print();
-        statsHistory.push_back(ai.getStatistics());
+            ai.getStatistics().print();
+            applyAIPause(demoMode);
+        }
+        if (telemetry_ != nullptr) {
+            // Ход сразу уходит в журнал, в памяти история не копится
+            char player = (currentPlayer == Player::X) ? 'X' : 'O';
+            telemetry_->record(gameId_, ++aiMovesMade_, player, move, eval.score,
+                               ai.getStatistics());
+        } else {
+            statsHistory.push_back(ai.getStatistics());
+        }
 
-        applyAIPause(demoMode);
         return move;
     }
 
+    // Итоговое поле: в режиме показа — последний кадр, если он
+    // ещё не нарисован (отрисовка через ход), иначе — как раньше
+    void showFinalBoard(TerminalRenderer& renderer, bool demoMode, bool frameCurrent) {
+        if (demoMode) {
+            if (!frameCurrent) {
+                renderer.render(board_, status_);
+            }
+            return;
+        }
+        clearScreen();
+        board_.print();
+    }
+
     // Экспорт статистики ИИ в CSV
     void exportStatisticsToCSV(const std::string& filename,
                                const DynamicArray<AIStatistics>& stats) {
@@ -134,16 +197,11 @@ private:
             return;
         }
 
-        // Можно и по-русски, но обычно для CSV удобнее латиница
-        file << "Move,NodesVisited,NodesGenerated,CacheHits,CacheMisses,TimeMs\n";
-
+        // Можно и по-русски, но обычно для CSV удобнее латиница.
+        // Столбцы общие с телеметрией (Telemetry.hpp)
+        telemetry::writeCsvRow(file, telemetry::columns());
         for (size_t i = 0; i < stats.size(); ++i) {
-            file << (i + 1) << ","
-                 << stats[i].nodesVisited << ","
-                 << stats[i].nodesGenerated << ","
-                 << stats[i].cacheHits << ","
-                 << stats[i].cacheMisses << ","
-                 << stats[i].timeMs << "\n";
+            telemetry::writeCsvRow(file, telemetry::values(i + 1, stats[i]));
         }
 
         file.close();
@@ -163,23 +221,90 @@ public:
           speedMode_(speedMode),
           openingRandomMovesDone_(0),
           openingRandomMovesLimit_(openingRandomMovesLimit),
-          rng_(std::random_device{}()) {}
+          rng_(std::random_device{}()),
+          telemetry_(nullptr),
+          gameId_(std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count()),
+          aiMovesMade_(0),
+          records_(nullptr),
+          record_(boardSize, winLength),
+          lastScore_(0),
+          renderEvery_(1) {
+        aiX_.setCacheLimit(AI_CACHE_LIMIT);
+        aiO_.setCacheLimit(AI_CACHE_LIMIT);
+        if (boardSize >= LARGE_BOARD_MIN_SIZE) {
+            aiX_.setLargeBoardMode();
+            aiO_.setLargeBoardMode();
+        }
+    }
+
+    // Включает запись отрезков поиска; в конце партии они выгружаются
+    // в filename в формате Chrome Trace (chrome://tracing, Perfetto)
+    void setTraceFile(const std::string& filename) {
+        traceFile_ = filename;
+    }
+
+    // Каждый ход ИИ пишется в sink (JSON Lines); вопрос о CSV
+    // в конце партии при этом не задаётся
+    void setTelemetry(telemetry::Sink* sink) {
+        telemetry_ = sink;
+    }
+
+    // Аппаратные счётчики (perf_event_open) в статистике ходов ИИ;
+    // по умолчанию выключены. Где они недоступны, статистика просто
+    // выводится без них.
+    void setHardwareCounters(bool enable) {
+        bool opened = aiX_.setHardwareCounters(enable);
+        aiO_.setHardwareCounters(enable);
+        if (enable && !opened) {
+            std::cerr << "Аппаратные счётчики недоступны: "
+                      << aiX_.hardwareCountersError() << std::endl;
+        }
+    }
+
+    // Быстрый показ ИИ vs ИИ: поле перерисовывается раз в n ходов
+    void setRenderEvery(int n) {
+        renderEvery_ = n;
+    }
+
+    // Партия целиком (ходы, оценки ИИ, итог) дописывается в архив
+    void setRecordWriter(records::Writer* writer) {
+        records_ = writer;
+    }
 
     void play() {
         Player currentPlayer = Player::X;
         DynamicArray<AIStatistics> statsHistory;
 
-        while (true) {
-            clearScreen();
-            board_.print();
-            std::cout << std::endl;
+        // ИИ vs ИИ рисуется TerminalRenderer: только изменения, без
+        // очистки экрана; пауза — после того, как ход уже на экране
+        bool demoMode = (!humanX_ && !humanO_);
+        TerminalRenderer renderer(std::cout);
+        renderer.setRenderEvery(speedMode_ == 1 ? renderEvery_ : 1);
+        int movesMade = 0;
+        bool frameCurrent = false;  // последний ход уже на экране
+        if (demoMode) {
+            status_.assign(1, "Ход игрока X");
+            renderer.render(board_, status_);
+        }
 
+        if (!traceFile_.empty()) {
+            Tracer::instance().clear();
+            Tracer::instance().setEnabled(true);
+        }
+
+        while (true) {
             CellState currentCell =
                 (currentPlayer == Player::X) ? CellState::X : CellState::O;
             bool isHuman =
                 (currentPlayer == Player::X) ? humanX_ : humanO_;
 
-            std::cout << "Ход игрока " << static_cast<char>(currentCell) << "\n";
+            if (!demoMode) {
+                clearScreen();
+                board_.print();
+                std::cout << "\n";
+                std::cout << "Ход игрока " << static_cast<char>(currentCell) << "\n";
+            }
 
             Coord move;
             if (isHuman) {
@@ -189,11 +314,23 @@ public:
             }
 
             board_.set(move, currentCell);
+            record_.addMove(move, isHuman ? 0 : lastScore_);
+            ++movesMade;
+
+            if (demoMode) {
+                status_.insert(status_.begin(), "Ход " + std::to_string(movesMade)
+                               + ": игрок " + static_cast<char>(currentCell));
+                frameCurrent = renderer.shouldRender(movesMade);
+                if (frameCurrent) {
+                    renderer.render(board_, status_);
+                }
+            }
 
             // Проверка победы
             if (board_.checkWin(currentCell)) {
-                clearScreen();
-                board_.print();
+                record_.result = (currentCell == CellState::X)
+                               ? records::Result::XWins : records::Result::OWins;
+                showFinalBoard(renderer, demoMode, frameCurrent);
                 std::cout << "\nПобедил игрок "
                           << static_cast<char>(currentCell) << "!\n";
 
@@ -221,8 +358,8 @@ public:
 
             // Проверка ничьей
             if (board_.isFull()) {
-                clearScreen();
-                board_.print();
+                record_.result = records::Result::Draw;
+                showFinalBoard(renderer, demoMode, frameCurrent);
                 std::cout << "\nНичья!\n";
 
                 if (!statsHistory.empty()) {
@@ -247,10 +384,36 @@ public:
                 break;
             }
 
+            if (demoMode && frameCurrent) {
+                applyAIPause(true);
+            }
+
             // Смена игрока
             currentPlayer = (currentPlayer == Player::X)
                           ? Player::O : Player::X;
         }
+
+        if (telemetry_ != nullptr) {
+            telemetry_->flush();
+        }
+        if (records_ != nullptr) {
+            if (!records_->write(record_)) {
+                std::cerr << "Партия на поле больше " << records::MAX_SIZE << "x"
+                          << records::MAX_SIZE << " в архив не пишется\n";
+            }
+            records_->flush();
+        }
+
+        if (!traceFile_.empty()) {
+            Tracer::instance().setEnabled(false);
+            if (Tracer::instance().writeChromeTrace(traceFile_)) {
+                std::cout << "Трассировка поиска сохранена в файл " << traceFile_
+                          << " (" << Tracer::instance().eventCount() << " отрезков)\n";
+            } else {
+                std::cerr << "Не удалось открыть файл: " << traceFile_ << std::endl;
+            }
+            Tracer::instance().clear();
+        }
     }
 };
 
@@ -326,7 +489,168 @@ void compareAlgorithms() {
     std::cin.get();
 }
 
-int main() {
+// Пакетный режим: партии ИИ vs ИИ без меню, очистки экрана и ожидания
+// ввода. Итог каждой партии — строка CSV (в файл --output или в stdout),
+// сводка — в stderr, чтобы не смешиваться с CSV.
+struct HeadlessOptions {
+    MatchConfig match;
+    int games = 1;
+    uint64_t seed = 1;
+    std::string output;
+};
+
+int runHeadless(const HeadlessOptions& options, telemetry::Sink* telemetrySink,
+                records::Writer* recordWriter) {
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file.is_open()) {
+            std::cerr << "Не удалось открыть файл результатов: " << options.output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+
+    out << "Game,Seed,Size,WinLength,EngineX,EngineO,Winner,Moves,"
+           "TimeUsX,TimeUsO,NodesX,NodesO,MoveList\n";
+
+    int wins[3] = {0, 0, 0};  // X, O, ничья
+    for (int game = 0; game < options.games; ++game) {
+        // Партии независимы: у каждой свой seed, выводимый из общего
+        uint64_t seed = options.seed + static_cast<uint64_t>(game);
+        GameResult result = playGame(options.match, seed, telemetrySink);
+        ++wins[result.winner == CellState::X ? 0 : result.winner == CellState::O ? 1 : 2];
+        if (recordWriter != nullptr) {
+            recordWriter->write(result.record);
+        }
+
+        out << game + 1 << ',' << seed << ','
+            << options.match.size << ',' << options.match.winLength << ','
+            << options.match.x.name() << ',' << options.match.o.name() << ','
+            << result.winnerName() << ',' << result.moves << ','
+            << result.timeUsX << ',' << result.timeUsO << ','
+            << result.nodesX << ',' << result.nodesO << ','
+            << '"' << result.moveList << "\"\n";
+    }
+    out.flush();
+
+    std::cerr << "Партий: " << options.games
+              << ", победы X: " << wins[0]
+              << ", победы O: " << wins[1]
+              << ", ничьи: " << wins[2] << "\n";
+    return 0;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Использование:\n"
+              << "  " << program << " [--telemetry FILE] [--record FILE] [--perf-counters]\n"
+              << "  " << program << " --engine   (текстовый протокол, см. EngineProtocol.hpp)\n"
+              << "  " << program << " --headless [--size N] [--win K] [--depth D]\n"
+              << "      [--engine-x ENGINE] [--engine-o ENGINE] [--games N] [--seed S]\n"
+              << "      [--random-opening N] [--output FILE] [--telemetry FILE]"
+              << " [--record FILE]\n"
+              << "ENGINE: minimax[:D], nomemo[:D], pattern[:D], random\n";
+}
+
+int main(int argc, char* argv[]) {
+    // --telemetry FILE: каждый ход ИИ дописывается в FILE (JSON Lines)
+    // сразу по ходу игры; перевод в CSV — telemetry_to_csv
+    std::unique_ptr<telemetry::Sink> telemetrySink;
+    // --record FILE: партии целиком дописываются в двоичный архив
+    // (GameRecord.hpp); разбор и статистика — game_records. Файл
+    // открывается после разбора всех ключей, когда известен --size
+    std::string recordPath;
+    std::unique_ptr<records::Writer> recordWriter;
+    // --perf-counters: аппаратные счётчики (perf_event_open) вокруг
+    // каждого поиска ИИ в статистике ходов
+    bool hardwareCounters = false;
+    bool headless = false;
+    bool engineMode = false;
+    HeadlessOptions headlessOptions;
+    int depth = 9;
+    std::string engineX = "minimax";
+    std::string engineO = "minimax";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--telemetry" && hasValue) {
+            telemetrySink.reset(new telemetry::Sink(argv[++i]));
+            if (!telemetrySink->isOpen()) {
+                std::cerr << "Не удалось открыть файл телеметрии: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--record" && hasValue) {
+            recordPath = argv[++i];
+        } else if (arg == "--perf-counters") {
+            hardwareCounters = true;
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--engine") {
+            engineMode = true;
+        } else if (arg == "--size" && hasValue) {
+            headlessOptions.match.size = std::atoi(argv[++i]);
+        } else if (arg == "--win" && hasValue) {
+            headlessOptions.match.winLength = std::atoi(argv[++i]);
+        } else if (arg == "--depth" && hasValue) {
+            depth = std::atoi(argv[++i]);
+        } else if (arg == "--engine-x" && hasValue) {
+            engineX = argv[++i];
+        } else if (arg == "--engine-o" && hasValue) {
+            engineO = argv[++i];
+        } else if (arg == "--games" && hasValue) {
+            headlessOptions.games = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            headlessOptions.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--random-opening" && hasValue) {
+            headlessOptions.match.randomOpeningMoves = std::atoi(argv[++i]);
+        } else if (arg == "--output" && hasValue) {
+            headlessOptions.output = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!recordPath.empty()) {
+        // Ход в архиве — один байт, так что партии на большом поле туда
+        // не помещаются; отказ сразу, а не пустой архив после всех партий
+        if (headless && headlessOptions.match.size > records::MAX_SIZE) {
+            std::cerr << "--record: партии на поле больше " << records::MAX_SIZE << "x"
+                      << records::MAX_SIZE << " в архив не пишутся\n";
+            return 1;
+        }
+        recordWriter.reset(new records::Writer(recordPath));
+        if (!recordWriter->isOpen()) {
+            std::cerr << "Не удалось открыть архив партий: " << recordPath << std::endl;
+            return 1;
+        }
+    }
+
+    // Долгоживущий движок: команды из stdin, ответы в stdout
+    if (engineMode) {
+        EngineSession session(std::cin, std::cout, 9, AI_CACHE_LIMIT);
+        session.run();
+        return 0;
+    }
+
+    if (headless) {
+        MatchConfig& match = headlessOptions.match;
+        match.cacheLimit = AI_CACHE_LIMIT;
+        if (!EngineSpec::parse(engineX, depth, match.x)
+            || !EngineSpec::parse(engineO, depth, match.o)) {
+            std::cerr << "Неизвестный движок: " << engineX << " / " << engineO << "\n";
+            return 1;
+        }
+        if (match.size < 3 || match.size > MAX_BOARD_SIZE || match.winLength < 3
+            || match.winLength > match.size || depth < 1 || headlessOptions.games < 1
+            || match.randomOpeningMoves < 0) {
+            std::cerr << "Некорректные параметры партии\n";
+            return 1;
+        }
+        return runHeadless(headlessOptions, telemetrySink.get(), recordWriter.get());
+    }
+
     while (true) {
         printMenu();
 
@@ -353,15 +677,17 @@ int main() {
         }
 
         int size;
-        std::cout << "\nРазмер поля (3-10): ";
-        while (!(std::cin >> size) || size < 3 || size > 10) {
-            std::cout << "Некорректный размер. Введите число от 3 до 10: ";
+        std::cout << "\nРазмер поля (3-" << MAX_BOARD_SIZE << "; больше "
+                  << LARGE_BOARD_MIN_SIZE - 1 << " — гомоку, ходы рядом с фишками): ";
+        while (!(std::cin >> size) || size < 3 || size > MAX_BOARD_SIZE) {
+            std::cout << "Некорректный размер. Введите число от 3 до " << MAX_BOARD_SIZE << ": ";
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
 
         int winLen;
-        std::cout << "Длина линии для выигрыша (3-" << size << "): ";
+        std::cout << "Длина линии для выигрыша (3-" << size
+                  << (size >= LARGE_BOARD_MIN_SIZE ? ", в гомоку 5" : "") << "): ";
         while (!(std::cin >> winLen) || winLen < 3 || winLen > size) {
             std::cout << "Некорректная длина. Введите число от 3 до " << size << ": ";
             std::cin.clear();
@@ -372,9 +698,11 @@ int main() {
         bool useMemo = true;
         int speedMode = 3;
         int openingRandomMovesLimit = 0;
+        int renderEvery = 1;
+        int traceSearch = 0;
 
         if (choice == 1 || choice == 2) {
-            int recommended = std::min(9, size * 2);
+            int recommended = size >= LARGE_BOARD_MIN_SIZE ? 5 : std::min(9, size * 2);
             std::cout << "Глубина поиска ИИ (1-9, рекомендовано "
                       << recommended << "): ";
             while (!(std::cin >> aiDepth) || aiDepth < 1 || aiDepth > 9) {
@@ -391,6 +719,13 @@ int main() {
                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             }
             useMemo = (memo == 1);
+
+            std::cout << "Записать трассировку поиска (Chrome trace)? (1=да, 0=нет): ";
+            while (!(std::cin >> traceSearch) || (traceSearch != 0 && traceSearch != 1)) {
+                std::cout << "Введите 1 (да) или 0 (нет): ";
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            }
         }
 
         bool humanX = false;
@@ -442,6 +777,15 @@ int main() {
                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             }
 
+            if (speedMode == 1) {
+                std::cout << "Рисовать поле раз в сколько ходов (1 — каждый ход): ";
+                while (!(std::cin >> renderEvery) || renderEvery < 1) {
+                    std::cout << "Введите целое число от 1: ";
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                }
+            }
+
             // КОЛИТЧЕСТВО РАНДОМНЫХ ХОДОВ В НАЧАЛЕ ОТ БОТОВ
             openingRandomMovesLimit = 2;
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -450,6 +794,13 @@ int main() {
         Game game(size, winLen, humanX, humanO,
                   aiDepth, useMemo,
                   speedMode, openingRandomMovesLimit);
+        if (traceSearch == 1) {
+            game.setTraceFile(TRACE_FILE);
+        }
+        game.setTelemetry(telemetrySink.get());
+        game.setRecordWriter(recordWriter.get());
+        game.setRenderEvery(renderEvery);
+        game.setHardwareCounters(hardwareCounters);
 
         game.play();
     }
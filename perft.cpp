@@ -0,0 +1,158 @@
+// perft.cpp — ЛР-3
+// Скорость "голой" доски: ход, откат, генерация ходов и проверка победы
+// без эвристик поиска. Считает листья дерева игры до заданной глубины
+// и сверяет их с эталоном.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread perft.cpp -o perft
+//
+// Запуск:
+//   perft SIZE WIN DEPTH [--split] [--threads N] [--backend board|compact]
+//   perft --verify [--backend board|compact]
+//
+// Код возврата 1 — число листьев не совпало с эталоном.
+
+#include "Board.hpp"
+#include "CompactBoard.hpp"
+#include "Perft.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct PerftOptions {
+    int size = 3;
+    int winLength = 3;
+    int depth = 9;
+    bool split = false;
+    unsigned threads = 1;
+    bool compact = false;
+};
+
+struct PerftRun {
+    uint64_t leaves;
+    double seconds;
+    std::vector<perft::RootMoveCount> byRoot;
+};
+
+template<typename B>
+PerftRun runPerft(const PerftOptions& options) {
+    B board(options.size, options.winLength);
+    PerftRun run;
+
+    auto start = std::chrono::steady_clock::now();
+    if (options.split || options.threads > 1) {
+        run.byRoot = perft::countByRootMove(board, options.depth, true, options.threads);
+        run.leaves = 0;
+        for (const perft::RootMoveCount& root : run.byRoot) {
+            run.leaves += root.leaves;
+        }
+    } else {
+        run.leaves = perft::countLeaves(board, options.depth, true);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    run.seconds = std::chrono::duration<double>(end - start).count();
+    return run;
+}
+
+PerftRun runPerft(const PerftOptions& options) {
+    return options.compact ? runPerft<CompactBoard>(options) : runPerft<Board>(options);
+}
+
+// true — совпало с эталоном или эталона нет
+bool report(const PerftOptions& options, const PerftRun& run) {
+    if (options.split) {
+        for (const perft::RootMoveCount& root : run.byRoot) {
+            std::cout << "  (" << root.move.row << "," << root.move.col << "): "
+                      << root.leaves << "\n";
+        }
+    }
+
+    double rate = run.seconds > 0.0 ? static_cast<double>(run.leaves) / run.seconds : 0.0;
+    std::cout << options.size << "x" << options.size
+              << " w" << options.winLength
+              << " d" << options.depth
+              << " [" << (options.compact ? "compact" : "board") << "]"
+              << ": " << run.leaves << " листьев за "
+              << std::fixed << std::setprecision(3) << run.seconds * 1000.0 << " мс ("
+              << std::setprecision(0) << rate << " листьев/с)";
+
+    uint64_t expected = perft::knownLeaves(options.size, options.winLength, options.depth);
+    if (expected == 0) {
+        std::cout << ", эталона нет\n";
+        return true;
+    }
+    if (expected != run.leaves) {
+        std::cout << ", ОШИБКА: ожидалось " << expected << "\n";
+        return false;
+    }
+    std::cout << ", совпадает с эталоном\n";
+    return true;
+}
+
+void printUsage() {
+    std::cout << "Использование:\n"
+              << "  perft SIZE WIN DEPTH [--split] [--threads N]"
+              << " [--backend board|compact]\n"
+              << "  perft --verify [--backend board|compact]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    PerftOptions options;
+    bool verify = false;
+    std::vector<int> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--split") {
+            options.split = true;
+        } else if (arg == "--verify") {
+            verify = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            int threads = std::atoi(argv[++i]);
+            options.threads = threads > 0 ? static_cast<unsigned>(threads) : 1;
+        } else if (arg == "--backend" && i + 1 < argc) {
+            options.compact = std::string(argv[++i]) == "compact";
+        } else if (!arg.empty() && arg[0] != '-') {
+            positional.push_back(std::atoi(arg.c_str()));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (verify) {
+        bool ok = true;
+        for (const perft::KnownValue& value : perft::knownValues()) {
+            PerftOptions check = options;
+            check.size = value.size;
+            check.winLength = value.winLength;
+            check.depth = value.depth;
+            check.split = false;
+            ok = report(check, runPerft(check)) && ok;
+        }
+        return ok ? 0 : 1;
+    }
+
+    if (positional.size() != 3) {
+        printUsage();
+        return 1;
+    }
+    options.size = positional[0];
+    options.winLength = positional[1];
+    options.depth = positional[2];
+    if (options.size < 1 || options.winLength < 1 || options.winLength > options.size
+        || options.depth < 0 || (options.compact && options.size > CompactBoard::MAX_SIZE)) {
+        std::cout << "Некорректные параметры\n";
+        return 1;
+    }
+
+    return report(options, runPerft(options)) ? 0 : 1;
+}
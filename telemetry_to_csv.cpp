@@ -0,0 +1,91 @@
+// telemetry_to_csv.cpp — ЛР-3
+// Перевод журнала телеметрии (JSON Lines, main --telemetry FILE)
+// в CSV с теми же столбцами, что и выгрузка статистики в конце партии.
+//
+// Сборка: g++ -std=c++17 -O2 telemetry_to_csv.cpp -o telemetry_to_csv
+//
+// Запуск: telemetry_to_csv INPUT.jsonl [OUTPUT.csv] [--game ID]
+// Без OUTPUT CSV печатается в стандартный вывод.
+
+#include "Telemetry.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    std::string inputPath;
+    std::string outputPath;
+    std::string gameFilter;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--game" && i + 1 < argc) {
+            gameFilter = argv[++i];
+        } else if (inputPath.empty()) {
+            inputPath = arg;
+        } else if (outputPath.empty()) {
+            outputPath = arg;
+        } else {
+            inputPath.clear();
+            break;
+        }
+    }
+    if (inputPath.empty()) {
+        std::cerr << "Использование: telemetry_to_csv INPUT.jsonl [OUTPUT.csv] [--game ID]\n";
+        return 1;
+    }
+
+    std::ifstream input(inputPath);
+    if (!input.is_open()) {
+        std::cerr << "Не удалось открыть файл: " << inputPath << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Не удалось открыть файл: " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : file;
+
+    telemetry::writeCsvRow(out, telemetry::columns());
+
+    std::string line;
+    telemetry::Record record;
+    size_t lineNumber = 0;
+    size_t rows = 0;
+    size_t skipped = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        if (line.empty()) {
+            continue;
+        }
+        // Последняя строка может быть оборвана падением процесса
+        if (!telemetry::parseLine(line, record)) {
+            std::cerr << "Строка " << lineNumber << " повреждена, пропущена\n";
+            ++skipped;
+            continue;
+        }
+        if (!gameFilter.empty()) {
+            bool match = false;
+            for (const auto& field : record) {
+                if (field.first == "GameId" && field.second == gameFilter) {
+                    match = true;
+                    break;
+                }
+            }
+            if (!match) {
+                continue;
+            }
+        }
+        telemetry::writeCsvRow(out, telemetry::csvRow(record));
+        ++rows;
+    }
+
+    std::cerr << "Записей: " << rows << ", пропущено: " << skipped << "\n";
+    return 0;
+}
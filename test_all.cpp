@@ -1,14 +1,38 @@
 // tests/test_all.cpp — ЛР-3
 // Тесты оформлены в том же стиле, что и Tests.hpp из ЛР-2
 
+#include "Analysis.hpp"
+#include "Arena.hpp"
 #include "Board.hpp"
+#include "CompactBoard.hpp"
 #include "MinimaxAI.hpp"
 #include "DynamicArray.hpp"
+#include "EngineProtocol.hpp"
+#include "GameRecord.hpp"
 #include "HashMap.hpp"
-
+#include "Match.hpp"
+#include "Notation.hpp"
+#include "PatternEval.hpp"
+#include "ConcurrentHashMap.hpp"
+#include "Perft.hpp"
+#include "Renderer.hpp"
+#include "SmallArray.hpp"
+#include "Telemetry.hpp"
+#include "Tournament.hpp"
+#include "Tracer.hpp"
+
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 class Tests {
 public:
@@ -50,8 +74,39 @@ public:
         TestBoardBoundaryChecks();     // 23
         TestEmptyBoardNoMoves();       // 24
 
+        std::cout << "\n=== Тесты HashMap (Swiss table) ===\n";
+        TestHashMapRemove();           // 25
+        TestHashMapTombstones();       // 26
+        TestHashMapFindEmplace();      // 27
+        TestHashMapIteration();        // 28
+        TestConcurrentHashMap();       // 29
+        TestHashMapBounded();          // 30
+        TestHashMapIncrementalRehash(); // 31
+        TestHashMapStats();            // 32
+
+        std::cout << "\n=== Тесты DynamicArray (сырая память) ===\n";
+        TestDynamicArrayNoDefaultConstruct(); // 33
+        TestDynamicArrayMoveOnly();    // 34
+        TestSmallArray();              // 35
+        TestArena();                   // 36
+        TestCompactBoard();            // 37
+        TestSearchProfile();           // 38
+        TestHardwareCounters();        // 39
+        TestPerft();                   // 40
+        TestTracer();                  // 41
+        TestTelemetry();               // 42
+        TestMatch();                   // 43
+        TestTournament();              // 44
+        TestTranspositionBounds();     // 45
+        TestEngineProtocol();          // 46
+        TestGameRecords();             // 47
+        TestNotation();                // 48
+        TestRenderer();                // 49
+        TestPatternEvaluator();        // 50
+        TestLargeBoard();              // 51
+
         std::cout << "\n========================================\n";
-        std::cout << "Все 24/24 тестов ЛР-3 пройдены успешно!\n";
+        std::cout << "Все 51/51 тестов ЛР-3 пройдены успешно!\n";
         std::cout << "========================================\n\n";
     }
 
@@ -206,7 +261,7 @@ private:
 
         Board board(3, 3);
 
-        DynamicArray<Coord> empty = board.getEmptyCells();
+        MoveList empty = board.getEmptyCells();
         assert(empty.size() == 9);
 
         board.set(0, 0, CellState::X);
@@ -476,14 +531,1503 @@ private:
         MinimaxAI ai(Player::O, 9, true);
         MoveEvaluation move = ai.findBestMove(board);
 
-        DynamicArray<Coord> empty = board.getEmptyCells();
+        MoveList empty = board.getEmptyCells();
         assert(empty.empty());
         (void)move; // просто чтобы не ругался компилятор
 
         std::cout << "OK\n";
     }
+
+    // ========== HashMap (Swiss table) ==========
+
+    static void TestHashMapRemove() {
+        std::cout << "Тест 25: HashMap — удаление и повторная вставка... ";
+
+        HashMap<int, std::string> map;
+        for (int i = 0; i < 200; ++i) {
+            map.insert(i, std::to_string(i));
+        }
+
+        // Ёмкость — степень двойки, загрузка не выше 7/8
+        size_t cap = map.capacity();
+        assert((cap & (cap - 1)) == 0);
+        assert(map.size() * 8 <= cap * 7);
+
+        for (int i = 0; i < 200; i += 2) {
+            map.remove(i);
+        }
+        map.remove(1000); // отсутствующий ключ — ничего не происходит
+        assert(map.size() == 100);
+
+        for (int i = 0; i < 200; ++i) {
+            assert(map.contains(i) == (i % 2 == 1));
+        }
+        assert(map.get(51) == "51");
+
+        map.insert(10, "ten");
+        assert(map.get(10) == "ten");
+        assert(map.size() == 101);
+
+        map.clear();
+        assert(map.empty());
+        assert(!map.contains(51));
+
+        std::cout << "OK\n";
+    }
+
+    static void TestHashMapTombstones() {
+        std::cout << "Тест 26: HashMap — много удалений без роста таблицы... ";
+
+        HashMap<size_t, int> map;
+        for (size_t i = 0; i < 10; ++i) {
+            map.insert(i, 0);
+        }
+        size_t cap = map.capacity();
+
+        // Постоянный размер при непрерывной смене ключей не должен
+        // раздувать таблицу: надгробия вычищаются на месте
+        for (size_t i = 10; i < 10000; ++i) {
+            map.insert(i, static_cast<int>(i));
+            map.remove(i - 10);
+        }
+        assert(map.size() == 10);
+        assert(map.capacity() == cap);
+
+        for (size_t i = 9990; i < 10000; ++i) {
+            assert(map.get(i) == static_cast<int>(i));
+        }
+
+        HashMap<size_t, int> copy = map;
+        assert(copy.size() == 10);
+        assert(copy.get(9999) == 9999);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestHashMapFindEmplace() {
+        std::cout << "Тест 27: HashMap — find/try_emplace/insert_or_assign... ";
+
+        HashMap<std::string, std::unique_ptr<int>> map;
+
+        auto r1 = map.try_emplace("a", new int(1));
+        assert(r1.second && **r1.first == 1);
+
+        // Повторный try_emplace не трогает существующее значение
+        auto r2 = map.try_emplace("a", nullptr);
+        assert(!r2.second && **r2.first == 1);
+        assert(r1.first == r2.first);
+
+        std::string key = "b";
+        auto r3 = map.insert_or_assign(std::move(key), std::make_unique<int>(3));
+        assert(r3.second);
+        auto r4 = map.insert_or_assign("b", std::make_unique<int>(4));
+        assert(!r4.second && **map.find("b") == 4);
+
+        assert(map.find("c") == nullptr);
+        const auto& cmap = map;
+        assert(cmap.find("a") != nullptr && **cmap.find("a") == 1);
+        assert(map.size() == 2);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestHashMapIteration() {
+        std::cout << "Тест 28: HashMap — обход и reserve... ";
+
+        HashMap<int, int> map;
+        map.reserve(1000);
+        size_t cap = map.capacity();
+        for (int i = 0; i < 1000; ++i) {
+            map.insert(i, i * 2);
+        }
+        assert(map.capacity() == cap);
+
+        map.remove(500);
+        long long sum = 0;
+        size_t count = 0;
+        for (const auto& entry : map) {
+            assert(entry.value == entry.key * 2);
+            sum += entry.key;
+            ++count;
+        }
+        assert(count == 999);
+        assert(sum == 999LL * 1000 / 2 - 500);
+
+        for (auto& entry : map) {
+            entry.value = 0;
+        }
+        assert(map.get(7) == 0);
+
+        HashMap<int, int> emptyMap;
+        assert(emptyMap.begin() == emptyMap.end());
+
+        std::cout << "OK\n";
+    }
+
+    static void TestConcurrentHashMap() {
+        std::cout << "Тест 29: ConcurrentHashMap — параллельная вставка... ";
+
+        ConcurrentHashMap<int, int> map(8);
+        assert(map.shardCount() == 8);
+
+        const int threads = 4;
+        const int perThread = 2000;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&map, t, perThread]() {
+                for (int i = 0; i < perThread; ++i) {
+                    int key = t * perThread + i;
+                    map.insert(key, key * 3);
+                    map.try_emplace(i, -1); // общие ключи — гонка за вставку
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        assert(map.size() == static_cast<size_t>(threads * perThread));
+        int value = 0;
+        assert(map.find(7777, value) && value == 7777 * 3);
+        assert(map.update(5, [](int& v) { v = 42; }));
+        assert(map.find(5, value) && value == 42);
+
+        map.remove(5);
+        assert(!map.contains(5));
+
+        std::cout << "OK\n";
+    }
+
+    static void TestHashMapBounded() {
+        std::cout << "Тест 30: HashMap — ограниченный режим с вытеснением CLOCK... ";
+
+        HashMap<int, int> map;
+        map.setMaxEntries(100);
+
+        size_t maxCapacity = 0;
+        for (int i = 1; i <= 10000; ++i) {
+            map.insert(i, i);
+            // "Горячий" ключ читается постоянно и должен пережить вытеснение
+            if (i > 1) {
+                assert(map.find(1) != nullptr);
+            }
+            maxCapacity = std::max(maxCapacity, map.capacity());
+            assert(map.size() <= 100);
+        }
+
+        assert(map.size() == 100);
+        assert(map.evictions() == 9900);
+        assert(map.contains(1));
+        assert(map.contains(10000));
+        assert(map.capacity() == maxCapacity);
+        assert(maxCapacity <= 256);
+
+        // Сужение лимита вытесняет лишнее сразу
+        map.setMaxEntries(10);
+        assert(map.size() == 10);
+        assert(map.evictions() == 9990);
+
+        // Бюджет памяти задаёт потолок в байтах
+        HashMap<int, int> budgeted;
+        budgeted.setMemoryBudget(64 * 1024);
+        for (int i = 0; i < 100000; ++i) {
+            budgeted.insert(i, i);
+        }
+        size_t bytes = budgeted.capacity() * (sizeof(HashMap<int, int>::Entry) + 2);
+        assert(bytes <= 64 * 1024);
+        assert(budgeted.size() == budgeted.maxEntries());
+
+        // Бюджет меньше минимальной таблицы не принимается
+        HashMap<int, int> tiny;
+        assert(!tiny.setMemoryBudget(100));
+        assert(tiny.maxEntries() == 0);
+
+        // На потолке надгробия чистятся на месте: ёмкость не меняется,
+        // все оставшиеся ключи находятся
+        HashMap<int, int> churn;
+        churn.setMaxEntries(500);
+        std::mt19937 rng(29);
+        std::vector<int> live;
+        size_t limitCapacity = 0;
+        for (int i = 0; i < 200000; ++i) {
+            if (!live.empty() && rng() % 2 == 0) {
+                size_t pick = rng() % live.size();
+                churn.remove(live[pick]);
+                live[pick] = live.back();
+                live.pop_back();
+            } else {
+                churn.insert(i, i);
+                live.push_back(i);
+            }
+            if (churn.size() == churn.maxEntries()) {
+                limitCapacity = std::max(limitCapacity, churn.capacity());
+            }
+            assert(limitCapacity == 0 || churn.capacity() == limitCapacity);
+        }
+        size_t found = 0;
+        for (int key : live) {
+            const int* value = churn.find(key);
+            if (value != nullptr) {
+                assert(*value == key);
+                ++found;
+            }
+        }
+        // Вытесненные CLOCK ключи пропадают, но всё, что осталось, — на месте
+        assert(found == churn.size());
+
+        std::cout << "OK\n";
+    }
+
+    static void TestHashMapIncrementalRehash() {
+        std::cout << "Тест 31: HashMap — инкрементальный рехеш... ";
+
+        HashMap<int, int> map;
+        map.setIncrementalRehash(true);
+
+        bool sawRehashing = false;
+        bool checkedMidMigration = false;
+        for (int i = 0; i < 5000; ++i) {
+            map.insert(i, i);
+            if (!map.isRehashing()) {
+                continue;
+            }
+            sawRehashing = true;
+
+            // Посреди переноса: все ключи доступны, обход видит обе таблицы
+            if (!checkedMidMigration && i > 1000) {
+                checkedMidMigration = true;
+                for (int k = 0; k <= i; ++k) {
+                    assert(map.contains(k));
+                }
+                size_t count = 0;
+                for (const auto& entry : map) {
+                    assert(entry.key == entry.value);
+                    ++count;
+                }
+                assert(count == map.size());
+
+                HashMap<int, int> copy = map;
+                assert(!copy.isRehashing());
+                assert(copy.size() == map.size());
+                assert(copy.get(0) == 0);
+
+                map.remove(0);            // ключ, ещё лежащий в старой таблице
+                assert(!map.contains(0));
+                map.insert(0, 0);
+                map.insert_or_assign(1, 100);
+                assert(map.get(1) == 100);
+                map.insert(1, 1);
+            }
+        }
+        assert(sawRehashing);
+        assert(checkedMidMigration);
+        assert(map.size() == 5000);
+        for (int i = 0; i < 5000; ++i) {
+            assert(map.get(i) == i);
+        }
+
+        map.setIncrementalRehash(false);
+        assert(!map.isRehashing());
+
+        // Вместе с ограниченным режимом: рост до потолка тоже постепенный
+        HashMap<int, int> bounded;
+        bounded.setIncrementalRehash(true);
+        bounded.setMaxEntries(1000);
+        for (int i = 0; i < 20000; ++i) {
+            bounded.insert(i, i);
+            assert(bounded.size() <= 1000);
+        }
+        assert(bounded.evictions() == 19000);
+        assert(bounded.contains(19999));
+
+        // С бюджетом память не выходит за него ни после одной операции,
+        // хотя перенос растянут на много вставок
+        const size_t budget = 4 * 1024;
+        HashMap<int, int> budgeted;
+        budgeted.setIncrementalRehash(true);
+        assert(budgeted.setMemoryBudget(budget));
+        std::mt19937 rng(30);
+        for (int i = 0; i < 100000; ++i) {
+            budgeted.insert(i, i);
+            if (rng() % 3 == 0) {
+                budgeted.remove(static_cast<int>(rng() % (i + 1)));
+            }
+            assert(budgeted.stats().bytesAllocated <= budget);
+        }
+        assert(budgeted.size() <= budgeted.maxEntries());
+
+        std::cout << "OK\n";
+    }
+
+    static void TestHashMapStats() {
+        std::cout << "Тест 32: HashMap — статистика заполнения... ";
+
+        // Удаление из заполненной группы оставляет надгробие
+        HashMap<int, int> map;
+        for (int i = 0; i < 1000; ++i) {
+            map.insert(i, i);
+        }
+        map.resetStats();
+        for (int i = 0; i < 1000; i += 2) {
+            map.remove(i);
+        }
+        for (int i = 0; i < 2000; ++i) {
+            map.contains(i);
+        }
+
+        HashMapStats stats = map.stats();
+        assert(stats.size == 500);
+        assert(stats.capacity == map.capacity());
+        assert(stats.loadFactor * stats.capacity == 500.0);
+        assert(stats.effectiveLoadFactor >= stats.loadFactor);
+        assert(stats.effectiveLoadFactor * stats.capacity == 500.0 + stats.tombstones);
+        assert(stats.bytesAllocated >= stats.capacity * sizeof(HashMap<int, int>::Entry));
+
+    #ifdef HASHMAP_STATS
+        assert(stats.detailed);
+        size_t hits = 0;
+        size_t misses = 0;
+        for (size_t i = 0; i < HashMapStats::PROBE_BUCKETS; ++i) {
+            hits += stats.hitProbes[i];
+            misses += stats.missProbes[i];
+        }
+        // 500 удалений нашли ключ; из 2000 contains — 500 попаданий
+        assert(hits == 1000);
+        assert(misses == 1500);
+        assert(stats.averageHitProbe() >= 1.0);
+    #else
+        assert(!stats.detailed);
+    #endif
+
+        std::cout << "OK\n";
+    }
+
+    // ========== DynamicArray (сырая память) ==========
+
+    // Тип без конструктора по умолчанию, считающий живые экземпляры
+    struct Counted {
+        static int alive;
+        int value;
+
+        explicit Counted(int v) : value(v) { ++alive; }
+        Counted(const Counted& other) : value(other.value) { ++alive; }
+        Counted(Counted&& other) noexcept : value(other.value) { ++alive; }
+        ~Counted() { --alive; }
+    };
+
+    static void TestDynamicArrayNoDefaultConstruct() {
+        std::cout << "Тест 33: DynamicArray — reserve без конструирования, emplace_back... ";
+
+        Counted::alive = 0;
+        {
+            DynamicArray<Counted> arr;
+            arr.reserve(100);
+            assert(arr.capacity() == 100);
+            assert(Counted::alive == 0);
+
+            for (int i = 0; i < 150; ++i) {
+                arr.emplace_back(i);
+            }
+            assert(Counted::alive == 150);
+
+            // Аргумент ссылается на элемент этого же массива во время роста
+            while (arr.size() < arr.capacity()) {
+                arr.emplace_back(0);
+            }
+            arr.push_back(arr[0]);
+            assert(arr.back().value == 0);
+
+            arr.pop_back();
+            arr.pop_back();
+            assert(Counted::alive == static_cast<int>(arr.size()));
+
+            arr.resize(10, Counted(7));
+            assert(arr.size() == 10);
+            assert(Counted::alive == 10);
+            arr.resize(20, Counted(7));
+            assert(arr[19].value == 7);
+
+            DynamicArray<Counted> copy = arr;
+            assert(Counted::alive == 40);
+            copy.clear();
+            assert(Counted::alive == 20);
+        }
+        assert(Counted::alive == 0);
+
+        DynamicArray<int> ints;
+        ints.resize(5);
+        assert(ints.size() == 5 && ints[4] == 0);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestDynamicArrayMoveOnly() {
+        std::cout << "Тест 34: DynamicArray — move-only элементы... ";
+
+        DynamicArray<std::unique_ptr<int>> arr;
+        for (int i = 0; i < 50; ++i) {
+            arr.push_back(std::make_unique<int>(i));
+        }
+        arr.emplace_back(new int(50));
+        assert(arr.size() == 51);
+        assert(*arr[50] == 50);
+
+        DynamicArray<std::unique_ptr<int>> moved = std::move(arr);
+        assert(arr.empty());
+        assert(*moved[10] == 10);
+
+        moved.resize(3);
+        assert(moved.size() == 3 && *moved[2] == 2);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestSmallArray() {
+        std::cout << "Тест 35: SmallArray — встроенный буфер и переход в кучу... ";
+
+        SmallArray<int, 4> arr;
+        for (int i = 0; i < 4; ++i) {
+            arr.push_back(i);
+        }
+        assert(arr.isSmall());
+        assert(arr.capacity() == 4);
+
+        arr.push_back(arr[0]); // переполнение, аргумент из самого массива
+        assert(!arr.isSmall());
+        assert(arr.size() == 5 && arr[4] == 0);
+
+        SmallArray<int, 4> copy = arr;
+        assert(copy.size() == 5 && copy[3] == 3);
+
+        SmallArray<int, 4> moved = std::move(arr);
+        assert(moved.size() == 5 && arr.empty() && arr.isSmall());
+
+        // Перемещение встроенного содержимого — поэлементно
+        SmallArray<std::unique_ptr<int>, 8> small;
+        small.emplace_back(new int(1));
+        small.push_back(std::make_unique<int>(2));
+        SmallArray<std::unique_ptr<int>, 8> smallMoved = std::move(small);
+        assert(smallMoved.isSmall() && *smallMoved[1] == 2);
+        smallMoved.pop_back();
+        assert(smallMoved.size() == 1);
+
+        // Ходы на поле до 10x10 не выделяют памяти
+        Board board(10, 5);
+        MoveList moves = board.getEmptyCells();
+        assert(moves.size() == 100);
+        assert(moves.isSmall());
+
+        std::cout << "OK\n";
+    }
+
+    static void TestArena() {
+        std::cout << "Тест 36: MonotonicArena — контейнеры в арене и reset... ";
+
+        MonotonicArena arena(256);
+
+        DynamicArray<int> arr(arena);
+        for (int i = 0; i < 1000; ++i) {
+            arr.push_back(i);
+        }
+        assert(arr.resource() == &arena);
+        assert(arr[999] == 999);
+
+        // Копия не привязана к арене оригинала
+        DynamicArray<int> copy = arr;
+        assert(copy.resource() != &arena && copy[500] == 500);
+
+        HashMap<int, std::string> map(arena);
+        for (int i = 0; i < 2000; ++i) {
+            map.insert(i, std::to_string(i));
+        }
+        assert(map.size() == 2000);
+        assert(*map.find(1234) == "1234");
+        assert(arena.bytesUsed() > 0);
+        assert(arena.bytesReserved() >= arena.bytesUsed());
+
+        // Выравнивание соблюдается и для больших запросов
+        void* aligned = arena.allocate(100, 64);
+        assert(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+
+        arr.clear();
+        map.clear();
+        {
+            DynamicArray<int> drop(std::move(arr));
+            HashMap<int, std::string> dropMap(std::move(map));
+        }
+        size_t reserved = arena.bytesReserved();
+        arena.reset();
+        assert(arena.bytesUsed() == 0);
+
+        // После reset блоки переиспользуются, новых не заводится
+        HashMap<int, int> again(arena);
+        for (int i = 0; i < 100; ++i) {
+            again.insert(i, i);
+        }
+        assert(arena.bytesReserved() == reserved);
+
+        // Поиск с таблицей на один ход даёт тот же результат
+        Board board(3, 3);
+        board.set(0, 0, CellState::X);
+        board.set(1, 1, CellState::O);
+        MinimaxAI persistent(Player::X, 9, true);
+        MinimaxAI perSearch(Player::X, 9, true);
+        perSearch.setPersistentCache(false);
+        MoveEvaluation a = persistent.findBestMove(board);
+        MoveEvaluation b = perSearch.findBestMove(board);
+        assert(a.score == b.score);
+        assert(perSearch.searchArena().bytesUsed() == 0);
+        assert(perSearch.searchArena().bytesReserved() > 0);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestCompactBoard() {
+        std::cout << "Тест 37: CompactBoard — встроенные клетки, ключ HashMap... ";
+
+        Board board(5, 4);
+        board.set(0, 0, CellState::X);
+        board.set(2, 3, CellState::O);
+
+        CompactBoard compact(board);
+        assert(compact.getSize() == 5 && compact.getWinLength() == 4);
+        assert(compact.get(2, 3) == CellState::O);
+        assert(compact.toBoard() == board);
+        assert(compact.getEmptyCells().size() == 23);
+
+        // Копия — побайтная, равенство — memcmp
+        CompactBoard copy = compact;
+        assert(copy == compact && copy.hash() == compact.hash());
+        copy.set(4, 4, CellState::X);
+        assert(copy != compact);
+
+        // Победа по антидиагонали, как у Board
+        CompactBoard diag(4, 4);
+        for (int k = 0; k < 4; ++k) {
+            diag.set(k, 3 - k, CellState::O);
+        }
+        assert(diag.checkWin(CellState::O) && !diag.checkWin(CellState::X));
+        assert(diag.toBoard().checkWin(CellState::O));
+
+        CompactBoard big(16, 5);
+        big.set(15, 15, CellState::X);
+        assert(big.get(15, 15) == CellState::X);
+
+        bool thrown = false;
+        try {
+            CompactBoard tooBig(17, 5);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        HashMap<CompactBoard, int> positions;
+        positions.insert(compact, 1);
+        positions.insert(copy, 2);
+        assert(positions.size() == 2);
+        assert(*positions.find(CompactBoard(board)) == 1);
+
+        // Передача в поток по значению
+        int found = 0;
+        std::thread worker([snapshot = compact, &found]() {
+            found = snapshot.get(0, 0) == CellState::X ? 1 : 0;
+        });
+        worker.join();
+        assert(found == 1);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestSearchProfile() {
+        std::cout << "Тест 38: профиль поиска по фазам... ";
+
+        Board board(3, 3);
+        board.set(0, 0, CellState::X);
+        MinimaxAI ai(Player::O, 9, true);
+        ai.findBestMove(board);
+        const AIStatistics& stats = ai.getStatistics();
+        const SearchProfile& profile = stats.profile;
+
+    #ifdef AI_PROFILE
+        assert(profile.enabled);
+        // Корень и все узлы minimax учтены по глубинам
+        uint64_t nodes = 0;
+        for (int ply = 0; ply < SearchProfile::MAX_PLY; ++ply) {
+            nodes += profile.nodesAtPly[ply];
+        }
+        assert(nodes == stats.nodesVisited + 1);
+        assert(profile.nodesAtPly[0] == 1 && profile.nodesAtPly[1] == 8);
+        assert(profile.phaseCalls[SearchProfile::CheckWin] == stats.nodesVisited);
+        assert(profile.phaseCalls[SearchProfile::TTProbe]
+               == stats.cacheHits + stats.cacheMisses);
+        assert(profile.phaseCalls[SearchProfile::Hash]
+               == profile.phaseCalls[SearchProfile::TTProbe]);
+        // Генерация ходов — в каждом раскрытом узле, включая корень
+        assert(profile.phaseCalls[SearchProfile::MoveGen] == profile.expandedNodes);
+        assert(profile.betaCutoffs > 0 && profile.betaCutoffs < profile.expandedNodes);
+        assert(profile.averageCutoffIndex() >= 1.0);
+        assert(profile.effectiveBranchingFactor() > 1.0);
+    #else
+        assert(!profile.enabled);
+        assert(profile.expandedNodes == 0 && profile.nodesPerPly() == "0");
+    #endif
+
+        std::cout << "OK\n";
+    }
+
+    static void TestHardwareCounters() {
+        std::cout << "Тест 39: аппаратные счётчики (или их отсутствие)... ";
+
+        HardwareCounters empty;
+        assert(!empty.available());
+        assert(empty.ipc() == 0.0 && empty.llcMissRate() == 0.0);
+
+        Board board(3, 3);
+        board.set(1, 1, CellState::X);
+        MinimaxAI plain(Player::O, 9, true);
+        MinimaxAI measured(Player::O, 9, true);
+        bool enabled = measured.setHardwareCounters(true);
+        assert(enabled || !measured.hardwareCountersError().empty());
+
+        // Без счётчиков поиск работает так же, результат не меняется
+        MoveEvaluation a = plain.findBestMove(board);
+        MoveEvaluation b = measured.findBestMove(board);
+        assert(a.move == b.move && a.score == b.score);
+        assert(!plain.getStatistics().hardware.available());
+        assert(measured.getStatistics().hardware.available() == enabled);
+        if (enabled && measured.getStatistics().hardware.has(HardwareCounters::Instructions)) {
+            assert(measured.getStatistics().hardware.get(HardwareCounters::Instructions) > 0);
+        }
+
+        measured.setHardwareCounters(false);
+        measured.findBestMove(board);
+        assert(!measured.getStatistics().hardware.available());
+
+        std::cout << "OK\n";
+    }
+
+    static void TestPerft() {
+        std::cout << "Тест 40: perft — число листьев дерева 3x3... ";
+
+        for (int depth = 1; depth <= 9; ++depth) {
+            Board board(3, 3);
+            assert(perft::countLeaves(board, depth, true) == perft::knownLeaves(3, 3, depth));
+        }
+
+        // Разбиение по ходам из корня в нескольких потоках, обе доски
+        CompactBoard compact(3, 3);
+        auto byRoot = perft::countByRootMove(compact, 9, true, 4);
+        assert(byRoot.size() == 9);
+        uint64_t total = 0;
+        for (const auto& root : byRoot) {
+            total += root.leaves;
+        }
+        assert(total == 255168);
+        assert(byRoot[0].leaves == 27732);  // угол
+        assert(byRoot[1].leaves == 29592);  // край
+        assert(byRoot[4].leaves == 25872);  // центр
+
+        Board board(4, 4);
+        assert(perft::countLeaves(board, 4, true) == perft::knownLeaves(4, 4, 4));
+
+        // Линия 3 на 4x4: победы внутри глубины обрезают листья
+        Board line3(4, 3);
+        assert(perft::countLeaves(line3, 6, true) == perft::knownLeaves(4, 3, 6));
+        CompactBoard compactLine3(4, 3);
+        assert(perft::countLeaves(compactLine3, 6, true) == perft::knownLeaves(4, 3, 6));
+        assert(perft::knownLeaves(4, 3, 6) < perft::knownLeaves(4, 4, 6));
+
+        std::cout << "OK\n";
+    }
+
+    static void TestTracer() {
+        std::cout << "Тест 41: трассировка поиска (Chrome trace)... ";
+
+        Tracer& tracer = Tracer::instance();
+        tracer.clear();
+
+        // Выключенная трассировка ничего не пишет
+        {
+            TraceSpan span("ignored");
+        }
+        assert(tracer.eventCount() == 0);
+
+        tracer.setEnabled(true);
+        Board board(3, 3);
+        board.set(1, 1, CellState::X);
+        MinimaxAI ai(Player::O, 9, true);
+        ai.findBestMove(board);
+
+        // Отрезки из другого потока попадают в свой буфер
+        std::thread worker([]() {
+            TraceSpan span("worker");
+            span.arg("value", 42);
+        });
+        worker.join();
+
+        // Таблица без хука сама отрезков не пишет
+        size_t eventsBefore = tracer.eventCount();
+        HashMap<int, int> plain;
+        for (int i = 0; i < 1000; ++i) {
+            plain.insert(i, i);
+        }
+        assert(tracer.eventCount() == eventsBefore);
+        tracer.setEnabled(false);
+
+        // findBestMove + 8 ходов корня + рост таблицы + worker
+        assert(tracer.eventCount() >= 11);
+
+        std::ostringstream out;
+        tracer.writeChromeTrace(out);
+        std::string json = out.str();
+        assert(json.find("\"traceEvents\"") != std::string::npos);
+        assert(json.find("\"name\": \"findBestMove\"") != std::string::npos);
+        assert(json.find("\"name\": \"rootMove\"") != std::string::npos);
+        assert(json.find("\"name\": \"HashMap::startMigration\"") != std::string::npos);
+        assert(json.find("\"value\": 42") != std::string::npos);
+        assert(json.find("\"tid\": 2") != std::string::npos);
+
+        tracer.clear();
+        assert(tracer.eventCount() == 0);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestTelemetry() {
+        std::cout << "Тест 42: телеметрия JSON Lines и обратно в CSV... ";
+
+        const char* path = "test_telemetry.jsonl";
+        std::remove(path);
+
+        Board board(3, 3);
+        board.set(0, 0, CellState::X);
+        MinimaxAI ai(Player::O, 9, true);
+        MoveEvaluation eval = ai.findBestMove(board);
+        AIStatistics stats = ai.getStatistics();
+        stats.profile.nodesAtPly[0] = 1;
+        stats.profile.nodesAtPly[1] = 8; // строковое поле "1;8"
+
+        {
+            telemetry::Sink sink(path, 2);
+            assert(sink.isOpen());
+            sink.record(7, 1, 'O', eval.move, eval.score, stats);
+            // До сброса (каждые 2 записи) файл ещё пуст
+            std::ifstream before(path);
+            std::string line;
+            assert(!std::getline(before, line));
+            sink.record(7, 2, 'O', eval.move, eval.score, stats);
+            sink.record(8, 1, 'X', eval.move, eval.score, stats);
+        } // деструктор сбрасывает остаток
+
+        std::ifstream in(path);
+        std::string line;
+        size_t lines = 0;
+        telemetry::Record record;
+        while (std::getline(in, line)) {
+            ++lines;
+            assert(telemetry::parseLine(line, record));
+            std::vector<std::string> row = telemetry::csvRow(record);
+            std::vector<std::string> expected = telemetry::values(lines < 3 ? lines : 1, stats);
+            assert(row == expected);
+        }
+        assert(lines == 3);
+        assert(record[0].first == "GameId" && record[0].second == "8");
+
+        // Оборванная строка не разбирается, а не даёт мусор
+        assert(!telemetry::parseLine("{\"GameId\": 1, \"Move\": \"1;", record));
+
+        std::remove(path);
+        std::cout << "OK\n";
+    }
+
+    static void TestMatch() {
+        std::cout << "Тест 43: партия без ввода-вывода (Match)... ";
+
+        EngineSpec spec;
+        assert(EngineSpec::parse("nomemo:4", 9, spec));
+        assert(spec.kind == EngineKind::MinimaxNoMemo && spec.depth == 4);
+        assert(EngineSpec::parse("minimax", 6, spec) && spec.depth == 6);
+        assert(spec.name() == "minimax:6");
+        assert(EngineSpec::parse("random", 6, spec) && spec.kind == EngineKind::Random);
+        assert(!EngineSpec::parse("minimax:0", 6, spec));
+        assert(!EngineSpec::parse("alphazero", 6, spec));
+
+        MatchConfig config;
+        config.size = 4;
+        config.winLength = 3;
+        config.x = EngineSpec(EngineKind::Minimax, 3);
+        config.o = EngineSpec(EngineKind::Random, 0);
+
+        // Один seed — одна и та же партия
+        GameResult first = playGame(config, 42);
+        GameResult second = playGame(config, 42);
+        assert(first.moveList == second.moveList);
+        assert(first.winner == second.winner && first.moves == second.moves);
+        assert(first.seed == 42 && first.nodesX > 0 && first.nodesO == 0);
+
+        // Ходов в списке столько же, сколько в партии
+        size_t listed = std::count(first.moveList.begin(), first.moveList.end(), ' ') + 1;
+        assert(static_cast<int>(listed) == first.moves);
+
+        // Случайные партии доигрываются до конца
+        config.x = EngineSpec(EngineKind::Random, 0);
+        for (uint64_t seed = 0; seed < 20; ++seed) {
+            GameResult result = playGame(config, seed);
+            assert(result.moves >= 5 && result.moves <= 16);
+            assert(result.winner != CellState::Empty || result.moves == 16);
+        }
+
+        std::cout << "OK\n";
+    }
+
+    static void TestTournament() {
+        std::cout << "Тест 44: турнир — Эло, SPRT и потоки... ";
+
+        tournament::Score score;
+        score.wins = 30;
+        score.draws = 40;
+        score.losses = 30;
+        assert(score.games() == 100 && score.points() == 0.5);
+        tournament::EloEstimate elo = tournament::estimateElo(score);
+        assert(std::abs(elo.elo) < 1e-9 && elo.lower < 0.0 && elo.upper > 0.0);
+        assert(std::abs(tournament::eloFromPoints(tournament::pointsFromElo(100.0)) - 100.0) < 1e-9);
+
+        // Явный перевес A: SPRT [0, 10] должен принять H1, равенство — H0
+        tournament::SprtConfig sprt;
+        score.wins = 300;
+        score.draws = 400;
+        score.losses = 100;
+        assert(tournament::sprtDecision(tournament::sprtLLR(score, sprt), sprt)
+               == tournament::SprtResult::AcceptH1);
+        score.wins = 3000;
+        score.draws = 4000;
+        score.losses = 3000;
+        assert(tournament::sprtDecision(tournament::sprtLLR(score, sprt), sprt)
+               == tournament::SprtResult::AcceptH0);
+
+        // Итог не зависит от числа потоков: у каждой пары свой seed
+        tournament::Config config;
+        config.match.size = 4;
+        config.match.winLength = 3;
+        config.match.x = EngineSpec(EngineKind::Minimax, 2);
+        config.match.o = EngineSpec(EngineKind::Random, 0);
+        config.pairs = 12;
+        tournament::Result single = tournament::run(config);
+        config.threads = 3;
+        int pairsSeen = 0;
+        tournament::Result parallel = tournament::run(config,
+            [&pairsSeen](const tournament::PairResult&, const tournament::Result&) { ++pairsSeen; });
+        assert(pairsSeen == 12 && parallel.pairsPlayed == 12);
+        assert(single.score.games() == 24);
+        assert(single.score.wins == parallel.score.wins);
+        assert(single.score.draws == parallel.score.draws);
+        assert(single.score.losses == parallel.score.losses);
+
+        // SPRT останавливает турнир раньше, чем кончатся пары
+        config.pairs = 10000;
+        config.useSprt = true;
+        tournament::Result stopped = tournament::run(config);
+        assert(stopped.sprt == tournament::SprtResult::AcceptH1);
+        assert(stopped.pairsPlayed < 10000);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestTranspositionBounds() {
+        std::cout << "Тест 45: таблица с границами, углубление и stop... ";
+
+        // С таблицей оценка обязана совпадать с поиском без таблицы:
+        // оценки с отсечением хранятся как границы, а не как точные
+        std::mt19937 rng(5);
+        for (int game = 0; game < 30; ++game) {
+            Board board(4, 3);
+            CellState cell = CellState::X;
+            int stones = 1 + game % 4;
+            for (int i = 0; i < stones; ++i) {
+                MoveList empty = board.getEmptyCells();
+                board.set(empty[rng() % empty.size()], cell);
+                cell = cell == CellState::X ? CellState::O : CellState::X;
+            }
+            if (board.checkWin(CellState::X) || board.checkWin(CellState::O)) {
+                continue;
+            }
+            Player side = cell == CellState::X ? Player::X : Player::O;
+            MinimaxAI memo(side, 5, true);
+            MinimaxAI plain(side, 5, false);
+            assert(memo.findBestMove(board).score == plain.findBestMove(board).score);
+        }
+
+        // Тот же случай, что ломал прежнюю таблицу: O в центре, X на краях
+        Board board(3, 3);
+        board.set(0, 1, CellState::X);
+        board.set(1, 1, CellState::O);
+        board.set(1, 2, CellState::X);
+        MinimaxAI ai(Player::O, 9, true);
+        MoveEvaluation move = ai.findBestMove(board);
+        assert(std::abs(move.score) < 1000);  // ничья, а не мнимая победа
+        assert(ai.getStatistics().depthReached == 9);
+
+        // Без лимита углубление доходит до maxDepth и даёт тот же ответ
+        MinimaxAI deepening(Player::O, 9, true);
+        MoveEvaluation timed = deepening.findBestMoveTimed(board, std::chrono::milliseconds(0));
+        assert(timed.score == move.score);
+        assert(deepening.getStatistics().depthReached == 9);
+        assert(!deepening.getStatistics().stopped);
+
+        // Счёт выигрыша из таблицы пересчитывается под глубину нового
+        // поиска: после поиска на 7 ходов поиск на 5 и на 3 видит ту же
+        // победу на 3-м ходу и тот же ход, что и движок с пустой таблицей
+        Board fork(5, 4);
+        fork.set(2, 2, CellState::X);
+        fork.set(2, 1, CellState::X);
+        fork.set(0, 0, CellState::O);
+        fork.set(4, 4, CellState::O);
+        for (int depth : {5, 3}) {
+            MinimaxAI fresh(Player::X, depth, true);
+            MoveEvaluation expected = fresh.findBestMove(fork);
+            MinimaxAI reused(Player::X, 7, true);
+            reused.findBestMove(fork);
+            reused.setMaxDepth(depth);
+            MoveEvaluation result = reused.findBestMove(fork);
+            assert(expected.score == 1000 + depth - 3);
+            assert(result.score == expected.score && result.move == expected.move);
+        }
+
+        // stop до поиска: первая итерация всё равно доигрывается
+        Board big(6, 4);
+        big.set(2, 2, CellState::X);
+        MinimaxAI stopped(Player::O, 9, true);
+        stopped.stop();
+        MoveEvaluation quick = stopped.findBestMoveTimed(big, std::chrono::milliseconds(0));
+        assert(stopped.getStatistics().stopped);
+        assert(stopped.getStatistics().depthReached == 1);
+        assert(big.isEmpty(quick.move));
+
+        // stop из другого потока посреди долгого поиска
+        std::thread stopper([&stopped]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            stopped.stop();
+        });
+        stopped.findBestMoveTimed(big, std::chrono::milliseconds(0));
+        stopper.join();
+        assert(stopped.getStatistics().stopped);
+        assert(stopped.getStatistics().depthReached < 9);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestEngineProtocol() {
+        std::cout << "Тест 46: движок с текстовым протоколом... ";
+
+        std::istringstream in(
+            "newgame 3 3\n"
+            "position 0,1 1,1 1,2\n"
+            "go\n"
+            "position 0,0 0,0\n"
+            "newgame 3 3\n"
+            "position 0,1 1,1 1,2\n"
+            "go depth=9\n"
+            "frobnicate\n"
+            "newgame 4 3\n"
+            "position 0,0\n"
+            "go time=50\n"
+            "quit\n"
+            "go\n");
+        std::ostringstream out;
+        size_t engines;
+        {
+            EngineSession session(in, out);
+            session.run();
+            engines = session.engineCount();
+        }
+        // Вторая партия 3x3 — тот же движок O, новый только на 4x4
+        assert(engines == 2);
+
+        std::istringstream replies(out.str());
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(replies, line)) {
+            lines.push_back(line);
+        }
+        assert(lines.size() == 11);
+        assert(lines[0] == "ok" && lines[1] == "ok");
+        assert(lines[2].compare(0, 13, "bestmove 0,2 ") == 0);
+        assert(lines[3] == "error bad move 0,0");
+        assert(lines[6].compare(0, 13, "bestmove 0,2 ") == 0);
+        assert(lines[7] == "error unknown command frobnicate");
+        assert(lines[10].compare(0, 9, "bestmove ") == 0);
+
+        // Тёплая таблица: тот же поиск во второй партии почти бесплатен
+        auto nodes = [](const std::string& reply) {
+            return std::atol(reply.c_str() + reply.find("nodes=") + 6);
+        };
+        assert(nodes(lines[6]) < nodes(lines[2]));
+
+        std::cout << "OK\n";
+    }
+
+    static void TestGameRecords() {
+        std::cout << "Тест 47: двоичный архив партий... ";
+
+        const char* path = "test_games.ttr";
+        std::remove(path);
+
+        records::GameRecord win(3, 3);
+        win.addMove(Coord(0, 0), 5);
+        win.addMove(Coord(1, 0), -70000);   // обрезается до int16
+        win.addMove(Coord(0, 1));
+        win.addMove(Coord(1, 1));
+        win.addMove(Coord(0, 2), 1004);
+        win.result = records::Result::XWins;
+
+        records::GameRecord noScores(4, 3);
+        noScores.addMove(Coord(3, 3));
+        noScores.scores.clear();
+        noScores.result = records::Result::Unfinished;
+
+        {
+            records::Writer writer(path);
+            assert(writer.isOpen());
+            writer.write(win);
+        }
+        {
+            // Второй писатель дописывает, не повторяя заголовок
+            records::Writer writer(path);
+            writer.write(noScores);
+            writer.write(win);
+        }
+
+        records::Archive archive;
+        assert(archive.open(path));
+        assert(archive.bytes() == 8 + 2 * (6 + 5 * 3) + (6 + 1));
+        std::vector<records::Result> seen;
+        size_t count = archive.forEach([&](const records::RecordView& game) {
+            seen.push_back(game.result);
+            if (game.result == records::Result::XWins) {
+                assert(game.moveCount == 5 && game.hasScores());
+                assert(game.move(4) == Coord(0, 2));
+                assert(game.score(0) == 5 && game.score(1) == -32768 && game.score(4) == 1004);
+                Board board(game.size, game.winLength);
+                assert(records::replay(game, board));
+                assert(board.checkWin(CellState::X));
+            } else {
+                assert(game.size == 4 && game.moveCount == 1 && !game.hasScores());
+                assert(game.move(0) == Coord(3, 3));
+                CompactBoard board(game.size, game.winLength);
+                assert(records::replay(game, board));
+            }
+        });
+        assert(count == 3 && !archive.truncated());
+        assert(seen[0] == records::Result::XWins && seen[1] == records::Result::Unfinished);
+        archive.close();
+
+        // Оборванная последняя запись пропускается и отмечается
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::app);
+            file.write("\x03\x03\x00\x00\x09\x00\x04", 7);
+        }
+        assert(archive.open(path));
+        assert(archive.forEach([](const records::RecordView&) {}) == 3);
+        assert(archive.truncated());
+
+        // Записанный итог не совпал с доской — повтор это видит
+        win.result = records::Result::Draw;
+        {
+            std::remove(path);
+            records::Writer writer(path);
+            writer.write(win);
+        }
+        assert(archive.open(path));
+        archive.forEach([](const records::RecordView& game) {
+            Board board(game.size, game.winLength);
+            assert(!records::replay(game, board));
+        });
+        archive.close();
+
+        // Не архив — не открывается
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file << "Move,NodesVisited\n";
+        }
+        assert(!archive.open(path) && !archive.error().empty());
+
+        std::remove(path);
+        std::cout << "OK\n";
+    }
+
+    static void TestNotation() {
+        std::cout << "Тест 48: нотация позиций и потоковый анализ... ";
+
+        Board board(5, 4);
+        board.set(0, 0, CellState::X);
+        board.set(2, 4, CellState::O);
+        board.set(4, 2, CellState::X);
+        assert(notation::sideToMove(board) == CellState::O);
+        std::string text = notation::toText(board);
+        assert(text == "5 4 X4/5/4O/5/2X2 O");
+
+        Board parsed;
+        CellState side = CellState::Empty;
+        assert(notation::parse(text, parsed, side));
+        assert(parsed == board && parsed.getWinLength() == 4 && side == CellState::O);
+        assert(notation::toText(parsed, side) == text);
+
+        // Большие поля: серии пустых клеток в две цифры, вплоть до 19x19
+        Board wide(12, 5);
+        wide.set(6, 11, CellState::X);
+        assert(notation::parse(notation::toText(wide), parsed, side));
+        assert(parsed == wide && side == CellState::O);
+
+        Board gomoku(MAX_BOARD_SIZE, 5);
+        gomoku.set(0, 18, CellState::X);
+        gomoku.set(9, 9, CellState::O);
+        gomoku.set(18, 0, CellState::X);
+        text = notation::toText(gomoku);
+        assert(text.compare(0, 11, "19 5 18X/19") == 0);
+        assert(notation::parse(text, parsed, side));
+        assert(parsed == gomoku && parsed.getWinLength() == 5 && side == CellState::O);
+        assert(notation::toText(parsed, side) == text);
+
+        // Очередь без SIDE выводится, строчные буквы допустимы
+        assert(notation::parse("3 3 x1o/1x1/3", parsed, side) && side == CellState::O);
+
+        std::string error;
+        const char* bad[] = {
+            "3 3 X1O/1X1",          // не хватает строки
+            "3 3 X1O/1X1/4",        // лишняя клетка
+            "3 3 XXX/O2/3",         // X на две фишки больше
+            "3 3 X1O/1X1/3 X",      // очередь не та
+            "3 3 X?O/3/3",
+            "17 3 17",              // 17x17 допустимо, но строк не хватает
+            "20 5 20/20/20/20/20/20/20/20/20/20/20/20/20/20/20/20/20/20/20/20",
+            "2 2 2/2",              // меньше 3x3
+            "3 2 3/3/3",            // линия короче 3
+            "3 4 3/3/3",
+            "",
+        };
+        for (const char* line : bad) {
+            error.clear();
+            assert(!notation::parse(line, parsed, side, &error));
+            assert(!error.empty());
+        }
+        // Неудачный разбор не портит прежний результат
+        assert(parsed.getSize() == 3 && side == CellState::O);
+
+        std::istringstream in(
+            "# позиции\n"
+            "3 3 X1O/1X1/3 O\n"
+            "\n"
+            "3 3 XXX/OO1/3\n"
+            "3 3 X,O/3/3\n"
+            "4 3 4/4/4/4\n");
+        std::ostringstream out;
+        StreamAnalyzer::Options options;
+        options.depth = 4;
+        options.flushEvery = 1;
+        StreamAnalyzer analyzer(options);
+        StreamAnalyzer::Summary summary = analyzer.run(in, out);
+        assert(summary.positions == 4 && summary.errors == 1 && summary.terminal == 1);
+
+        std::istringstream result(out.str());
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(result, line)) {
+            lines.push_back(line);
+        }
+        assert(lines.size() == 5 && lines[0] == StreamAnalyzer::header());
+        // Все строки — ровно 8 столбцов, даже с запятой во входе
+        for (const std::string& row : lines) {
+            assert(std::count(row.begin(), row.end(), ',') == 7);
+        }
+        assert(lines[1].compare(0, 24, "2,3 3 X1O/1X1/3 O,ok,2 2") == 0);
+        assert(lines[2] == "4,3 3 XXX/OO1/3,X,,,,,");
+        assert(lines[3].compare(0, 21, "5,3 3 X;O/3/3,error: ") == 0);
+
+        // Поле от 11x11 разбирается в режиме большой доски: ходы только
+        // рядом с фишками, иначе глубина 4 на 15x15 не уложилась бы в тест
+        std::istringstream large(
+            "15 5 15/15/15/15/15/15/15/5XXXX6/5OOO7/9O5/15/15/15/15/15\n");
+        std::ostringstream largeOut;
+        StreamAnalyzer largeAnalyzer(options);
+        summary = largeAnalyzer.run(large, largeOut);
+        assert(summary.positions == 1 && summary.errors == 0);
+        assert(summary.nodes < 10000);
+        std::string row = largeOut.str().substr(std::string(StreamAnalyzer::header()).size() + 1);
+        assert(row.find(",ok,7 4,") != std::string::npos || row.find(",ok,7 9,") != std::string::npos);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestRenderer() {
+        std::cout << "Тест 49: отрисовка партии разностными кадрами... ";
+
+        Board board(3, 3);
+        std::string empty = board.toString();
+        assert(empty == "  0 1 2 \n0  | | \n  -+-+-\n1  | | \n  -+-+-\n2  | | \n");
+
+        std::ostringstream out;
+        TerminalRenderer renderer(out, true);
+        std::vector<std::string> status = {"Ход 0", "старт"};
+        renderer.render(board, status);
+        std::string first = out.str();
+        assert(first == "\x1b[2J\x1b[H" + empty + "\nХод 0\nстарт\n");
+
+        // Вторая отрисовка: одна клетка и одна строка состояния
+        out.str("");
+        board.set(1, 1, CellState::X);
+        status[0] = "Ход 1";
+        renderer.render(board, status);
+        std::string diff = out.str();
+        assert(diff == "\x1b[4;5HX\x1b[8;1H\x1b[2KХод 1\x1b[10;1H\x1b[J");
+        assert(diff.find("старт") == std::string::npos);
+
+        // Ничего не поменялось — только сброс хвоста экрана
+        out.str("");
+        renderer.render(board, status);
+        assert(out.str() == "\x1b[10;1H\x1b[J");
+
+        // После постороннего вывода — снова полный кадр
+        out.str("");
+        renderer.invalidate();
+        renderer.render(board, status);
+        assert(out.str().compare(0, 7, "\x1b[2J\x1b[H") == 0);
+        assert(renderer.framesRendered() == 4);
+
+        // На полях больше 10 номер строки шире — столбец клетки сдвигается
+        Board wide(11, 5);
+        out.str("");
+        renderer.render(wide, status);
+        out.str("");
+        wide.set(10, 0, CellState::O);
+        renderer.render(wide, status);
+        assert(out.str().compare(0, 9, "\x1b[22;4HO\x1b") == 0);
+
+        // Без ANSI каждый кадр полный и без управляющих кодов
+        std::ostringstream plain;
+        TerminalRenderer fallback(plain, false);
+        fallback.render(board, status);
+        fallback.render(board, status);
+        std::string expected = board.toString() + "\nХод 1\nстарт\n";
+        assert(plain.str() == expected + expected);
+        assert(fallback.bytesWritten() == 2 * expected.size());
+
+        fallback.setRenderEvery(3);
+        assert(fallback.shouldRender(3) && fallback.shouldRender(6));
+        assert(!fallback.shouldRender(4));
+        fallback.setRenderEvery(0);
+        assert(fallback.shouldRender(5));
+
+        std::cout << "OK\n";
+    }
+
+    static void TestPatternEvaluator() {
+        std::cout << "Тест 50: оценка образцами в окнах линий... ";
+
+        PatternEvaluator patterns;
+        patterns.prepare(3);
+        assert(patterns.winLength() == 3);
+        assert(patterns.windowScore(0) == 0);
+        assert(patterns.windowScore(1) == 1);           // X__
+        assert(patterns.windowScore(1 + 3) == 4);       // XX_
+        assert(patterns.windowScore(2 + 2 * 9) == -4);  // O_O
+        assert(patterns.windowScore(1 + 2 * 3) == 0);   // XO_ — мёртвое окно
+        assert(!PatternEvaluator::supports(PatternEvaluator::MAX_LENGTH + 1));
+
+        // Полная оценка и приращения сверяются с прямым подсчётом окон
+        auto bruteForce = [](const Board& board) {
+            static const int dirs[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+            int size = board.getSize();
+            int len = board.getWinLength();
+            int score = 0;
+            for (const auto& dir : dirs) {
+                for (int row = 0; row < size; ++row) {
+                    for (int col = 0; col < size; ++col) {
+                        int endRow = row + (len - 1) * dir[0];
+                        int endCol = col + (len - 1) * dir[1];
+                        if (endRow >= size || endCol < 0 || endCol >= size) {
+                            continue;
+                        }
+                        int x = 0;
+                        int o = 0;
+                        for (int i = 0; i < len; ++i) {
+                            CellState cell = board.get(row + i * dir[0], col + i * dir[1]);
+                            x += cell == CellState::X;
+                            o += cell == CellState::O;
+                        }
+                        if (x == 0 && o > 0) {
+                            score -= 1 << (2 * (o - 1));
+                        } else if (o == 0 && x > 0) {
+                            score += 1 << (2 * (x - 1));
+                        }
+                    }
+                }
+            }
+            return score;
+        };
+
+        std::mt19937 rng(49);
+        const int shapes[][2] = {{3, 3}, {5, 4}, {7, 4}, {8, 5}, {10, 5}};
+        for (const auto& shape : shapes) {
+            Board board(shape[0], shape[1]);
+            patterns.prepare(shape[1]);
+            int score = patterns.evaluate(board);
+            assert(score == 0);
+            for (int step = 0; step < 200; ++step) {
+                int row = static_cast<int>(rng() % shape[0]);
+                int col = static_cast<int>(rng() % shape[0]);
+                CellState cell = static_cast<CellState>(" XO"[rng() % 3]);
+                score += patterns.delta(board, row, col, cell);
+                board.set(row, col, cell);
+                assert(score == bruteForce(board));
+            }
+            assert(score == patterns.evaluate(board));
+        }
+
+        // Уже на глубине 1 оценка образцами достраивает свою двойку
+        // в открытую тройку, а не просто занимает клетку у центра
+        Board board(7, 4);
+        board.set(3, 3, CellState::X);
+        board.set(3, 4, CellState::X);
+        board.set(0, 0, CellState::O);
+        board.set(6, 6, CellState::O);
+        MinimaxAI ai(Player::X, 1, true);
+        ai.setEvaluator(Evaluator::Pattern);
+        assert(ai.getEvaluator() == Evaluator::Pattern);
+        MoveEvaluation eval = ai.findBestMove(board);
+        assert(eval.move == Coord(3, 2) || eval.move == Coord(3, 5));
+        assert(eval.score > 0);
+        assert(std::abs(eval.score) < 1000);
+
+        EngineSpec spec;
+        assert(EngineSpec::parse("pattern:3", 9, spec));
+        assert(spec.kind == EngineKind::Pattern && spec.name() == "pattern:3");
+        MatchConfig config;
+        config.size = 5;
+        config.winLength = 4;
+        config.x = spec;
+        config.o = EngineSpec(EngineKind::Minimax, 2);
+        GameResult first = playGame(config, 7);
+        assert(first.moves > 0 && first.moveList == playGame(config, 7).moveList);
+
+        std::cout << "OK\n";
+    }
+
+    static void TestLargeBoard() {
+        std::cout << "Тест 51: большое поле — Zobrist, победа по последнему ходу... ";
+
+        // Хеш ведётся приращениями и не зависит от порядка ходов
+        Board a(19, 5);
+        Board b(19, 5);
+        a.set(9, 9, CellState::X);
+        a.set(3, 17, CellState::O);
+        a.set(18, 0, CellState::X);
+        b.set(18, 0, CellState::X);
+        b.set(3, 17, CellState::O);
+        b.set(9, 9, CellState::X);
+        assert(a.hash() == b.hash() && a.stoneCount() == 3);
+        b.set(9, 9, CellState::O);
+        assert(a.hash() != b.hash() && b.stoneCount() == 3);
+        b.set(9, 9, CellState::Empty);
+        b.set(3, 17, CellState::Empty);
+        b.set(18, 0, CellState::Empty);
+        assert(b.hash() == Board(19, 5).hash() && b.stoneCount() == 0);
+
+        Board full(3, 3);
+        for (int i = 0; i < 9; ++i) {
+            assert(!full.isFull());
+            full.set(i / 3, i % 3, i % 2 == 0 ? CellState::X : CellState::O);
+        }
+        assert(full.isFull());
+
+        // Проверка по последнему ходу совпадает с полной на случайных партиях
+        std::mt19937 rng(50);
+        for (int game = 0; game < 50; ++game) {
+            Board board(15, 5);
+            bool won = false;
+            for (int move = 0; !won && move < 225; ++move) {
+                MoveList empty = board.getEmptyCells();
+                Coord cell = empty[rng() % empty.size()];
+                CellState side = move % 2 == 0 ? CellState::X : CellState::O;
+                board.set(cell, side);
+                won = board.checkWinAt(cell);
+                assert(won == board.checkWin(side));
+            }
+        }
+
+        // На полях больше 10x10 номера строк выровнены по двум цифрам
+        std::string text = Board(11, 5).toString();
+        assert(text.compare(0, 26, "   0 1 2 3 4 5 6 7 8 9 0 \n") == 0);
+        assert(text.find("\n 9  |") != std::string::npos);
+        assert(text.find("\n10  |") != std::string::npos);
+
+        // Режим большой доски: своя четвёрка достраивается, чужая закрывается
+        Board board(19, 5);
+        for (int col = 5; col < 9; ++col) {
+            board.set(9, col, CellState::X);
+        }
+        board.set(10, 5, CellState::O);
+        board.set(10, 6, CellState::O);
+        board.set(10, 7, CellState::O);
+        board.set(11, 11, CellState::O);
+        MinimaxAI ai(Player::X, 4, true);
+        ai.setLargeBoardMode();
+        assert(ai.getMoveRadius() == LARGE_BOARD_MOVE_RADIUS);
+        MoveEvaluation eval = ai.findBestMove(board);
+        assert(eval.move == Coord(9, 4) || eval.move == Coord(9, 9));
+        assert(eval.score >= 1000);
+        // Поиск идёт только около фишек: узлов на порядки меньше полного
+        assert(ai.getStatistics().nodesVisited < 10000);
+
+        board.set(9, 4, CellState::O);
+        MinimaxAI defender(Player::O, 3, true);
+        defender.setLargeBoardMode();
+        board.set(12, 12, CellState::X);
+        eval = defender.findBestMove(board);
+        assert(eval.move == Coord(9, 9));
+
+        // Смена радиуса сбрасывает таблицу: поиск идёт как у нового
+        // движка с тем же радиусом, а не по оценкам от другого набора ходов
+        Board sparse(11, 5);
+        sparse.set(5, 5, CellState::X);
+        sparse.set(5, 6, CellState::O);
+        MinimaxAI narrow(Player::X, 3, true);
+        narrow.setMoveRadius(1);
+        narrow.findBestMove(sparse);
+        narrow.setMoveRadius(1);
+        narrow.findBestMove(sparse);
+        size_t cachedNodes = narrow.getStatistics().nodesVisited;
+        narrow.setMoveRadius(2);
+        narrow.findBestMove(sparse);
+        MinimaxAI wide(Player::X, 3, true);
+        wide.setMoveRadius(2);
+        wide.findBestMove(sparse);
+        assert(narrow.getStatistics().nodesVisited == wide.getStatistics().nodesVisited);
+        assert(cachedNodes < wide.getStatistics().nodesVisited);
+
+        // Протокол и пакетные партии принимают поле 19x19
+        std::istringstream in("newgame 19 5\nposition 9,9 8,8\ngo depth=3\nquit\n");
+        std::ostringstream out;
+        {
+            EngineSession session(in, out);
+            session.run();
+        }
+        assert(out.str().find("bestmove ") != std::string::npos);
+        assert(out.str().find("error") == std::string::npos);
+
+        MatchConfig config;
+        config.size = 15;
+        config.winLength = 5;
+        config.x = EngineSpec(EngineKind::Pattern, 3);
+        config.o = EngineSpec(EngineKind::Pattern, 2);
+        GameResult result = playGame(config, 11);
+        assert(result.moves > 5 && result.winner != CellState::Empty);
+
+        std::cout << "OK\n";
+    }
 };
 
+int Tests::Counted::alive = 0;
+
 int main() {
     Tests::RunAllTests();
     return 0;
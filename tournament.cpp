@@ -0,0 +1,178 @@
+// tournament.cpp — ЛР-3
+// Турнир двух конфигураций ИИ на самоигре: тысячи партий параллельно
+// на всех ядрах, случайные начала, смена цвета в каждой паре партий.
+// Итог — победы/ничьи/поражения движка A, разница Эло с 95% интервалом
+// и (по желанию) SPRT с досрочной остановкой.
+//
+// Сборка: g++ -std=c++17 -O2 -pthread tournament.cpp -o tournament
+//
+// Запуск:
+//   tournament --engine-a SPEC --engine-b SPEC [--size N] [--win K] [--depth D]
+//              [--pairs N] [--threads N] [--seed S] [--random-opening N]
+//              [--sprt ELO0 ELO1] [--alpha A] [--beta B] [--csv FILE]
+//   SPEC: minimax[:D], nomemo[:D], pattern[:D], random
+//
+// Код возврата: 0 — турнир сыгран, 2 — SPRT принял H0, 1 — ошибка.
+
+#include "Match.hpp"
+#include "Tournament.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+const char* sprtName(tournament::SprtResult result) {
+    switch (result) {
+        case tournament::SprtResult::AcceptH0: return "H0 принята";
+        case tournament::SprtResult::AcceptH1: return "H1 принята";
+        case tournament::SprtResult::Continue: break;
+    }
+    return "нет решения";
+}
+
+void writeGameRow(std::ostream& out, int pair, const char* aColor, const GameResult& game) {
+    out << pair + 1 << ',' << game.seed << ',' << aColor << ','
+        << game.winnerName() << ',' << game.moves << ','
+        << game.timeUsX << ',' << game.timeUsO << ','
+        << game.nodesX << ',' << game.nodesO << ','
+        << '"' << game.moveList << "\"\n";
+}
+
+void printUsage() {
+    std::cout << "Использование:\n"
+              << "  tournament --engine-a SPEC --engine-b SPEC [--size N] [--win K]"
+              << " [--depth D]\n"
+              << "             [--pairs N] [--threads N] [--seed S] [--random-opening N]\n"
+              << "             [--sprt ELO0 ELO1] [--alpha A] [--beta B] [--csv FILE]\n"
+              << "  SPEC: minimax[:D], nomemo[:D], pattern[:D], random\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    tournament::Config config;
+    config.match.cacheLimit = 1 << 19;
+    config.threads = std::thread::hardware_concurrency();
+    int depth = 9;
+    std::string engineA;
+    std::string engineB;
+    std::string csvPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--engine-a" && hasValue) {
+            engineA = argv[++i];
+        } else if (arg == "--engine-b" && hasValue) {
+            engineB = argv[++i];
+        } else if (arg == "--size" && hasValue) {
+            config.match.size = std::atoi(argv[++i]);
+        } else if (arg == "--win" && hasValue) {
+            config.match.winLength = std::atoi(argv[++i]);
+        } else if (arg == "--depth" && hasValue) {
+            depth = std::atoi(argv[++i]);
+        } else if (arg == "--pairs" && hasValue) {
+            config.pairs = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            int threads = std::atoi(argv[++i]);
+            config.threads = threads > 0 ? static_cast<unsigned>(threads) : 1;
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--random-opening" && hasValue) {
+            config.match.randomOpeningMoves = std::atoi(argv[++i]);
+        } else if (arg == "--sprt" && i + 2 < argc) {
+            config.useSprt = true;
+            config.sprt.elo0 = std::atof(argv[++i]);
+            config.sprt.elo1 = std::atof(argv[++i]);
+        } else if (arg == "--alpha" && hasValue) {
+            config.sprt.alpha = std::atof(argv[++i]);
+        } else if (arg == "--beta" && hasValue) {
+            config.sprt.beta = std::atof(argv[++i]);
+        } else if (arg == "--csv" && hasValue) {
+            csvPath = argv[++i];
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (engineA.empty() || engineB.empty()
+        || !EngineSpec::parse(engineA, depth, config.match.x)
+        || !EngineSpec::parse(engineB, depth, config.match.o)) {
+        printUsage();
+        return 1;
+    }
+    if (config.match.size < 3 || config.match.size > MAX_BOARD_SIZE || config.match.winLength < 3
+        || config.match.winLength > config.match.size || config.pairs < 1
+        || config.match.randomOpeningMoves < 0 || config.sprt.alpha <= 0.0
+        || config.sprt.alpha >= 1.0 || config.sprt.beta <= 0.0 || config.sprt.beta >= 1.0
+        || config.sprt.elo0 >= config.sprt.elo1) {
+        std::cout << "Некорректные параметры\n";
+        return 1;
+    }
+    if (config.threads == 0) {
+        config.threads = 1;
+    }
+
+    std::ofstream csv;
+    if (!csvPath.empty()) {
+        csv.open(csvPath);
+        if (!csv.is_open()) {
+            std::cout << "Не удалось открыть " << csvPath << "\n";
+            return 1;
+        }
+        csv << "Pair,Seed,EngineAColor,Winner,Moves,TimeUsX,TimeUsO,NodesX,NodesO,MoveList\n";
+    }
+
+    std::cout << "A = " << config.match.x.name() << ", B = " << config.match.o.name()
+              << ", поле " << config.match.size << "x" << config.match.size
+              << " (линия " << config.match.winLength << "), пар: " << config.pairs
+              << ", потоков: " << config.threads << "\n";
+
+    // Прогресс — примерно десять строк за турнир
+    int progressEvery = config.pairs >= 10 ? config.pairs / 10 : 1;
+    tournament::Result result = tournament::run(config,
+        [&](const tournament::PairResult& pair, const tournament::Result& current) {
+            if (csv.is_open()) {
+                writeGameRow(csv, pair.index, "X", pair.aAsX);
+                writeGameRow(csv, pair.index, "O", pair.aAsO);
+            }
+            if (current.pairsPlayed % progressEvery == 0) {
+                std::cout << "  пар " << current.pairsPlayed
+                          << ": +" << current.score.wins << " =" << current.score.draws
+                          << " -" << current.score.losses;
+                if (config.useSprt) {
+                    std::cout << ", LLR " << std::fixed << std::setprecision(2) << current.llr;
+                }
+                std::cout << "\n";
+            }
+        });
+
+    const tournament::Score& score = result.score;
+    tournament::EloEstimate elo = tournament::estimateElo(score);
+    double gamesPerHour = result.seconds > 0.0 ? score.games() * 3600.0 / result.seconds : 0.0;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "\nПартий: " << score.games()
+              << " (A: +" << score.wins << " =" << score.draws << " -" << score.losses << ")"
+              << ", очки A: " << score.points() * 100.0 << "%\n"
+              << "Эло A - B: " << elo.elo
+              << " [" << elo.lower << ", " << elo.upper << "] (95%)\n";
+    if (config.useSprt) {
+        std::cout << std::setprecision(2)
+                  << "SPRT [" << config.sprt.elo0 << ", " << config.sprt.elo1 << "]"
+                  << ": LLR " << result.llr
+                  << " (границы " << config.sprt.lowerBound() << ", "
+                  << config.sprt.upperBound() << "), " << sprtName(result.sprt) << "\n";
+    }
+    std::cout << std::setprecision(1)
+              << "Время: " << result.seconds << " с, " << std::setprecision(0)
+              << gamesPerHour << " партий/ч\n";
+
+    return result.sprt == tournament::SprtResult::AcceptH0 ? 2 : 0;
+}